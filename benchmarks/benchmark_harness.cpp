@@ -0,0 +1,142 @@
+#include "benchmark_harness.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+
+namespace spk::Benchmarks
+{
+	State::State(std::size_t iterations) :
+		_iterations(iterations)
+	{
+	}
+
+	std::size_t State::iterations() const noexcept
+	{
+		return _iterations;
+	}
+
+	State::Clock::duration State::elapsed() const noexcept
+	{
+		return _elapsed;
+	}
+
+	std::size_t State::itemsPerIteration() const noexcept
+	{
+		return _itemsPerIteration;
+	}
+
+	void State::setItemsPerIteration(std::size_t count) noexcept
+	{
+		_itemsPerIteration = count;
+	}
+
+	void Registry::add(std::string name, std::function<void(State &)> body)
+	{
+		_cases.push_back(Case{.name = std::move(name), .body = std::move(body)});
+	}
+
+	const std::vector<Case> &Registry::cases() const noexcept
+	{
+		return _cases;
+	}
+
+	Runner::Runner(Configuration configuration) :
+		_configuration(std::move(configuration))
+	{
+		if (_configuration.repetitions == 0)
+			throw std::invalid_argument("A benchmark requires at least one repetition");
+	}
+
+	std::size_t Runner::_calibrate(const Case &benchmark) const
+	{
+		std::size_t iterations = 1;
+		while (true)
+		{
+			State state(iterations);
+			benchmark.body(state);
+			if (state.elapsed() >= _configuration.minimalRepetitionTime || iterations >= (std::size_t{1} << 30))
+				return iterations;
+			iterations *= 2;
+		}
+	}
+
+	Result Runner::_measure(const Case &benchmark) const
+	{
+		const std::size_t iterations = _calibrate(benchmark);
+
+		std::vector<double> samples;
+		samples.reserve(_configuration.repetitions);
+		std::size_t itemsPerIteration = 1;
+		for (std::size_t repetition = 0; repetition < _configuration.repetitions; ++repetition)
+		{
+			State state(iterations);
+			benchmark.body(state);
+			itemsPerIteration = state.itemsPerIteration();
+			const double nanoseconds = std::chrono::duration<double, std::nano>(state.elapsed()).count();
+			samples.push_back(nanoseconds / static_cast<double>(iterations));
+		}
+
+		std::ranges::sort(samples);
+		const double median = samples[samples.size() / 2];
+		return Result{
+			.name = benchmark.name,
+			.iterations = iterations,
+			.minimalNanoseconds = samples.front(),
+			.medianNanoseconds = median,
+			.itemsPerSecond = median > 0.0 ? static_cast<double>(itemsPerIteration) * 1e9 / median : 0.0};
+	}
+
+	std::vector<Result> Runner::run(const Registry &registry) const
+	{
+		std::vector<Result> results;
+		for (const Case &benchmark : registry.cases())
+		{
+			if (!_configuration.filter.empty() && benchmark.name.find(_configuration.filter) == std::string::npos)
+				continue;
+			results.push_back(_measure(benchmark));
+		}
+		return results;
+	}
+
+	void Runner::printTable(std::ostream &stream, const std::vector<Result> &results)
+	{
+		const std::ios::fmtflags flags = stream.flags();
+		stream << std::left << std::setw(48) << "Benchmark" << std::right
+			   << std::setw(12) << "Iterations"
+			   << std::setw(16) << "Min (ns)"
+			   << std::setw(16) << "Median (ns)"
+			   << std::setw(16) << "Items/s" << '\n';
+		for (const Result &result : results)
+		{
+			stream << std::left << std::setw(48) << result.name << std::right
+				   << std::setw(12) << result.iterations
+				   << std::fixed << std::setprecision(1)
+				   << std::setw(16) << result.minimalNanoseconds
+				   << std::setw(16) << result.medianNanoseconds
+				   << std::scientific << std::setprecision(3)
+				   << std::setw(16) << result.itemsPerSecond << '\n';
+		}
+		stream.flags(flags);
+	}
+
+	void Runner::writeJson(std::ostream &stream, const std::vector<Result> &results)
+	{
+		const std::ios::fmtflags flags = stream.flags();
+		stream << std::fixed << std::setprecision(3);
+		stream << "{\n  \"benchmarks\": [";
+		for (std::size_t index = 0; index < results.size(); ++index)
+		{
+			const Result &result = results[index];
+			stream << (index == 0 ? "\n" : ",\n")
+				   << "    {\"name\": \"" << result.name << '"'
+				   << ", \"iterations\": " << result.iterations
+				   << ", \"min_ns\": " << result.minimalNanoseconds
+				   << ", \"median_ns\": " << result.medianNanoseconds
+				   << ", \"items_per_second\": " << result.itemsPerSecond << '}';
+		}
+		stream << "\n  ]\n}\n";
+		stream.flags(flags);
+	}
+}
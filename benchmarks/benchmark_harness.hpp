@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace spk::Benchmarks
+{
+	template <typename TValue>
+	inline void doNotOptimize(const TValue &value)
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		static_cast<void>(*static_cast<const volatile char *>(static_cast<const void *>(&value)));
+#else
+		asm volatile("" : : "g"(&value) : "memory");
+#endif
+	}
+
+	class State
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+	private:
+		std::size_t _iterations;
+		std::size_t _itemsPerIteration = 1;
+		Clock::duration _elapsed = Clock::duration::zero();
+
+	public:
+		explicit State(std::size_t iterations);
+
+		[[nodiscard]] std::size_t iterations() const noexcept;
+		[[nodiscard]] Clock::duration elapsed() const noexcept;
+		[[nodiscard]] std::size_t itemsPerIteration() const noexcept;
+
+		void setItemsPerIteration(std::size_t count) noexcept;
+
+		template <typename TFunction>
+		void run(TFunction &&function)
+		{
+			const Clock::time_point start = Clock::now();
+			for (std::size_t iteration = 0; iteration < _iterations; ++iteration)
+				function();
+			_elapsed += Clock::now() - start;
+		}
+	};
+
+	struct Case
+	{
+		std::string name;
+		std::function<void(State &)> body;
+	};
+
+	class Registry
+	{
+	private:
+		std::vector<Case> _cases;
+
+	public:
+		void add(std::string name, std::function<void(State &)> body);
+		[[nodiscard]] const std::vector<Case> &cases() const noexcept;
+	};
+
+	struct Result
+	{
+		std::string name;
+		std::size_t iterations = 0;
+		double minimalNanoseconds = 0.0;
+		double medianNanoseconds = 0.0;
+		double itemsPerSecond = 0.0;
+	};
+
+	class Runner
+	{
+	public:
+		struct Configuration
+		{
+			std::string filter;
+			std::size_t repetitions = 5;
+			std::chrono::milliseconds minimalRepetitionTime{50};
+			std::optional<std::string> jsonPath;
+		};
+
+	private:
+		Configuration _configuration;
+
+		[[nodiscard]] std::size_t _calibrate(const Case &benchmark) const;
+		[[nodiscard]] Result _measure(const Case &benchmark) const;
+
+	public:
+		explicit Runner(Configuration configuration);
+
+		[[nodiscard]] std::vector<Result> run(const Registry &registry) const;
+
+		static void printTable(std::ostream &stream, const std::vector<Result> &results);
+		static void writeJson(std::ostream &stream, const std::vector<Result> &results);
+	};
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "benchmark_harness.hpp"
+
+namespace spk::Benchmarks
+{
+	void registerCachedDataBenchmarks(Registry &registry);
+	void registerContractProviderBenchmarks(Registry &registry);
+	void registerFIFOBenchmarks(Registry &registry);
+	void registerRenderCommandStreamBenchmarks(Registry &registry);
+	void registerThreadSafeSlotBenchmarks(Registry &registry);
+	void registerWidgetBenchmarks(Registry &registry);
+}
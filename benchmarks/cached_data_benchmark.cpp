@@ -0,0 +1,91 @@
+#include "benchmarks.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cached_data.hpp"
+#include "widget.hpp"
+
+namespace spk::Benchmarks
+{
+	namespace
+	{
+		constexpr std::size_t ChainLength = 256;
+		constexpr std::size_t WidgetDepth = 32;
+		constexpr std::size_t WidgetFanOut = 8;
+
+		/**
+		 * A chain of caches where each value derives from the previous one, invalidated from its head the way a
+		 * widget's absolute z-order and view region are when an ancestor changes.
+		 */
+		class Chain
+		{
+		private:
+			std::vector<std::unique_ptr<CachedData<std::uint64_t>>> _links;
+
+		public:
+			explicit Chain(std::size_t length)
+			{
+				_links.reserve(length);
+				for (std::size_t index = 0; index < length; ++index)
+				{
+					const CachedData<std::uint64_t> *previous = index == 0 ? nullptr : _links.back().get();
+					_links.push_back(std::make_unique<CachedData<std::uint64_t>>([previous, index] {
+						return (previous != nullptr ? **previous : 0) + index;
+					}));
+				}
+			}
+
+			void invalidate() const
+			{
+				for (const auto &link : _links)
+					link->invalidate();
+			}
+
+			[[nodiscard]] std::uint64_t tail() const
+			{
+				return **_links.back();
+			}
+		};
+	}
+
+	void registerCachedDataBenchmarks(Registry &registry)
+	{
+		registry.add("CachedData/Chain/" + std::to_string(ChainLength), [](State &state) {
+			const Chain chain(ChainLength);
+			state.setItemsPerIteration(ChainLength);
+			state.run([&] {
+				chain.invalidate();
+				doNotOptimize(chain.tail());
+			});
+		});
+
+		registry.add("CachedData/WidgetGeometryCascade", [](State &state) {
+			// A spine of WidgetDepth widgets, each also holding WidgetFanOut leaves, moved from the root.
+			std::vector<std::unique_ptr<Widget>> widgets;
+			Widget *parent = nullptr;
+			for (std::size_t depth = 0; depth < WidgetDepth; ++depth)
+			{
+				widgets.push_back(std::make_unique<Widget>("spine" + std::to_string(depth), parent));
+				parent = widgets.back().get();
+				for (std::size_t leaf = 0; leaf < WidgetFanOut; ++leaf)
+					widgets.push_back(std::make_unique<Widget>("leaf" + std::to_string(widgets.size()), parent));
+			}
+
+			Rect2D geometry;
+			geometry.size = {512, 512};
+			state.setItemsPerIteration(widgets.size());
+			state.run([&] {
+				geometry.x = (geometry.x + 1) % 16;
+				widgets.front()->setGeometry(geometry);
+				for (const auto &widget : widgets)
+					doNotOptimize(widget->viewRegion());
+			});
+
+			while (!widgets.empty())
+				widgets.pop_back();
+		});
+	}
+}
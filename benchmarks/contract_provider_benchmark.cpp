@@ -0,0 +1,40 @@
+#include "benchmarks.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "contract_provider.hpp"
+
+namespace spk::Benchmarks
+{
+	namespace
+	{
+		void benchmarkTrigger(State &state, std::size_t subscriberCount)
+		{
+			ContractProvider<int> provider;
+			std::uint64_t checksum = 0;
+			std::vector<ContractProvider<int>::Contract> contracts;
+			contracts.reserve(subscriberCount);
+			for (std::size_t index = 0; index < subscriberCount; ++index)
+				contracts.push_back(provider.subscribe([&checksum](int value) { checksum += static_cast<std::uint64_t>(value); }));
+
+			state.setItemsPerIteration(subscriberCount);
+			int value = 0;
+			state.run([&] {
+				provider.trigger(++value);
+			});
+			doNotOptimize(checksum);
+		}
+	}
+
+	void registerContractProviderBenchmarks(Registry &registry)
+	{
+		for (const std::size_t subscriberCount : {1, 16, 256})
+		{
+			registry.add("ContractProvider/Trigger/" + std::to_string(subscriberCount), [subscriberCount](State &state) {
+				benchmarkTrigger(state, subscriberCount);
+			});
+		}
+	}
+}
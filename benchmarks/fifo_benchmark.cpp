@@ -0,0 +1,124 @@
+#include "benchmarks.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "mpsc_fifo.hpp"
+#include "spsc_fifo.hpp"
+#include "thread_safe_fifo.hpp"
+
+namespace spk::Benchmarks
+{
+	namespace
+	{
+		constexpr std::size_t MessageCount = 1 << 16;
+		constexpr std::size_t ProducerCount = 4;
+		constexpr std::size_t BatchSize = 64;
+
+		/** Stand-in for a mouse-move record: a window identifier-sized header and a position. */
+		struct Message
+		{
+			std::uint64_t sequence;
+			std::int32_t x;
+			std::int32_t y;
+			std::uint64_t padding[2];
+		};
+
+		template <typename TEndpoints>
+		void benchmarkTransfer(State &state, TEndpoints (*create)())
+		{
+			state.setItemsPerIteration(MessageCount);
+			state.run([&] {
+				auto endpoints = create();
+				std::jthread producer([&producer = endpoints.producer] {
+					for (std::size_t index = 0; index < MessageCount; ++index)
+					{
+						producer.publish(Message{.sequence = index, .x = static_cast<std::int32_t>(index), .y = 0, .padding = {}});
+					}
+				});
+
+				std::uint64_t checksum = 0;
+				std::size_t received = 0;
+				while (received < MessageCount)
+				{
+					for (const Message &message : endpoints.consumer.drain())
+					{
+						checksum += message.sequence;
+						++received;
+					}
+				}
+				doNotOptimize(checksum);
+			});
+		}
+
+		template <typename TEndpoints>
+		void benchmarkContendedTransfer(State &state, TEndpoints (*create)(), bool isBatched)
+		{
+			state.setItemsPerIteration(MessageCount);
+			state.run([&] {
+				auto endpoints = create();
+				std::vector<std::jthread> producers;
+				for (std::size_t producerIndex = 0; producerIndex < ProducerCount; ++producerIndex)
+				{
+					producers.emplace_back([producer = endpoints.producer, isBatched]() mutable {
+						std::vector<Message> batch;
+						for (std::size_t index = 0; index < MessageCount / ProducerCount; ++index)
+						{
+							Message message{.sequence = index, .x = static_cast<std::int32_t>(index), .y = 0, .padding = {}};
+							if (!isBatched)
+							{
+								producer.publish(message);
+								continue;
+							}
+							batch.push_back(message);
+							if (batch.size() == BatchSize)
+							{
+								producer.publishBatch(batch);
+								batch.clear();
+							}
+						}
+						producer.publishBatch(batch);
+					});
+				}
+
+				std::uint64_t checksum = 0;
+				std::size_t received = 0;
+				while (received < MessageCount)
+				{
+					for (const Message &message : endpoints.consumer.drain())
+					{
+						checksum += message.sequence;
+						++received;
+					}
+				}
+				doNotOptimize(checksum);
+			});
+		}
+	}
+
+	void registerFIFOBenchmarks(Registry &registry)
+	{
+		registry.add("FIFO/Transfer/ThreadSafeFIFO", [](State &state) {
+			benchmarkTransfer(state, &ThreadSafeFIFO<Message>::create);
+		});
+		registry.add("FIFO/Transfer/SPSCFIFO", [](State &state) {
+			benchmarkTransfer(state, &SPSCFIFO<Message>::create);
+		});
+		registry.add("FIFO/Transfer/MPSCFIFO", [](State &state) {
+			benchmarkTransfer(state, &MPSCFIFO<Message>::create);
+		});
+		registry.add("FIFO/Contended/ThreadSafeFIFO", [](State &state) {
+			benchmarkContendedTransfer(state, &ThreadSafeFIFO<Message>::create, false);
+		});
+		registry.add("FIFO/Contended/MPSCFIFO", [](State &state) {
+			benchmarkContendedTransfer(state, &MPSCFIFO<Message>::create, false);
+		});
+		registry.add("FIFO/ContendedBatch/ThreadSafeFIFO", [](State &state) {
+			benchmarkContendedTransfer(state, &ThreadSafeFIFO<Message>::create, true);
+		});
+		registry.add("FIFO/ContendedBatch/MPSCFIFO", [](State &state) {
+			benchmarkContendedTransfer(state, &MPSCFIFO<Message>::create, true);
+		});
+	}
+}
@@ -0,0 +1,68 @@
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "benchmark_harness.hpp"
+#include "benchmarks.hpp"
+
+namespace
+{
+	spk::Benchmarks::Runner::Configuration parseArguments(int argc, char **argv)
+	{
+		spk::Benchmarks::Runner::Configuration result;
+		for (int index = 1; index < argc; ++index)
+		{
+			const std::string_view argument = argv[index];
+			if (index + 1 >= argc)
+				throw std::invalid_argument("Missing value for argument [" + std::string(argument) + "]");
+			const std::string value = argv[++index];
+
+			if (argument == "--filter")
+				result.filter = value;
+			else if (argument == "--json")
+				result.jsonPath = value;
+			else if (argument == "--repetitions")
+				result.repetitions = std::stoul(value);
+			else
+				throw std::invalid_argument("Unknown argument [" + std::string(argument) + "]");
+		}
+		return result;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	try
+	{
+		const auto configuration = parseArguments(argc, argv);
+
+		spk::Benchmarks::Registry registry;
+		spk::Benchmarks::registerFIFOBenchmarks(registry);
+		spk::Benchmarks::registerThreadSafeSlotBenchmarks(registry);
+		spk::Benchmarks::registerContractProviderBenchmarks(registry);
+		spk::Benchmarks::registerWidgetBenchmarks(registry);
+		spk::Benchmarks::registerCachedDataBenchmarks(registry);
+		spk::Benchmarks::registerRenderCommandStreamBenchmarks(registry);
+
+		const auto results = spk::Benchmarks::Runner(configuration).run(registry);
+		spk::Benchmarks::Runner::printTable(std::cout, results);
+
+		if (configuration.jsonPath.has_value())
+		{
+			std::ofstream output(*configuration.jsonPath);
+			if (!output)
+				throw std::runtime_error("Cannot open [" + *configuration.jsonPath + "]");
+			spk::Benchmarks::Runner::writeJson(output, results);
+		}
+		return EXIT_SUCCESS;
+	}
+	catch (const std::exception &exception)
+	{
+		std::cerr << exception.what() << '\n';
+		return EXIT_FAILURE;
+	}
+}
@@ -0,0 +1,168 @@
+#include "benchmarks.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "clear_render_command.hpp"
+#include "render_backend.hpp"
+#include "render_command.hpp"
+#include "render_command_arena.hpp"
+#include "render_context.hpp"
+#include "render_pass.hpp"
+#include "scissor_render_command.hpp"
+#include "viewport_render_command.hpp"
+
+namespace spk::Benchmarks
+{
+	namespace
+	{
+		constexpr std::size_t WidgetCount = 2048;
+		constexpr std::size_t CommandCount = WidgetCount * 2 + WidgetCount / 32;
+
+		class CountingBackend final : public RenderBackend
+		{
+		private:
+			std::uint64_t _checksum = 0;
+
+		public:
+			void execute(const RenderPass &pass, RenderContext &renderContext) override
+			{
+				pass.play(*this, renderContext);
+			}
+
+			void beginFrame(const Vector2UInt &) override
+			{
+			}
+
+			void setViewport(const Rect2D &viewport) override
+			{
+				_checksum += static_cast<std::uint64_t>(viewport.x) + viewport.width;
+			}
+
+			void setScissor(const Rect2D &scissor) override
+			{
+				_checksum += static_cast<std::uint64_t>(scissor.y) + scissor.height;
+			}
+
+			void clear(const Color &, ClearRenderCommand::Mask mask) override
+			{
+				_checksum += static_cast<std::uint64_t>(mask);
+			}
+
+			void endFrame() override
+			{
+			}
+
+			[[nodiscard]] std::uint64_t checksum() const noexcept
+			{
+				return _checksum;
+			}
+		};
+
+		Rect2D makeRect(std::size_t index)
+		{
+			Rect2D result;
+			result.x = static_cast<int>(index % 97);
+			result.y = static_cast<int>(index % 89);
+			result.width = static_cast<unsigned int>(16 + index % 64);
+			result.height = static_cast<unsigned int>(16 + index % 48);
+			return result;
+		}
+
+		/**
+		 * Emits the command mix of a typical widget tree: each widget sets its viewport and scissor,
+		 * and one in every thirty-two clears its background.
+		 */
+		template <typename TSink>
+		void emitCommands(TSink &&sink)
+		{
+			for (std::size_t index = 0; index < WidgetCount; ++index)
+			{
+				sink.template operator()<ViewportRenderCommand>(makeRect(index));
+				sink.template operator()<ScissorRenderCommand>(makeRect(index + 1));
+				if (index % 32 == 0)
+					sink.template operator()<ClearRenderCommand>(Color{0.1f, 0.2f, 0.3f, 1.0f}, ClearRenderCommand::Mask::Color);
+			}
+		}
+
+		using VirtualCommandList = std::vector<std::unique_ptr<RenderCommand>>;
+
+		void fillVirtual(VirtualCommandList &commands)
+		{
+			emitCommands([&]<typename TCommand>(auto &&...args) {
+				commands.push_back(std::make_unique<TCommand>(args...));
+			});
+		}
+
+		void fillStream(RenderPass &pass)
+		{
+			emitCommands([&]<typename TCommand>(auto &&...args) {
+				pass.emplace<TCommand>(args...);
+			});
+		}
+
+		void benchmarkVirtualBuild(State &state)
+		{
+			state.setItemsPerIteration(CommandCount);
+			state.run([] {
+				VirtualCommandList commands;
+				fillVirtual(commands);
+				doNotOptimize(commands);
+			});
+		}
+
+		void benchmarkStreamBuild(State &state)
+		{
+			const auto pool = std::make_shared<RenderCommandArena::Pool>();
+			state.setItemsPerIteration(CommandCount);
+			state.run([&] {
+				RenderCommandArena arena(pool);
+				RenderPass pass(arena);
+				fillStream(pass);
+				doNotOptimize(pass);
+			});
+		}
+
+		void benchmarkVirtualExecute(State &state)
+		{
+			VirtualCommandList commands;
+			fillVirtual(commands);
+
+			CountingBackend backend;
+			RenderContext renderContext{.targetSurface = nullptr, .backend = &backend};
+
+			state.setItemsPerIteration(commands.size());
+			state.run([&] {
+				for (const auto &command : commands)
+					command->execute(renderContext);
+			});
+			doNotOptimize(backend.checksum());
+		}
+
+		void benchmarkStreamExecute(State &state)
+		{
+			const auto pool = std::make_shared<RenderCommandArena::Pool>();
+			RenderCommandArena arena(pool);
+			RenderPass pass(arena);
+			fillStream(pass);
+
+			CountingBackend backend;
+			RenderContext renderContext{.targetSurface = nullptr, .backend = &backend};
+
+			state.setItemsPerIteration(pass.size());
+			state.run([&] {
+				pass.execute(renderContext);
+			});
+			doNotOptimize(backend.checksum());
+		}
+	}
+
+	void registerRenderCommandStreamBenchmarks(Registry &registry)
+	{
+		registry.add("RenderCommands/Build/Virtual", benchmarkVirtualBuild);
+		registry.add("RenderCommands/Build/Stream", benchmarkStreamBuild);
+		registry.add("RenderCommands/Execute/Virtual", benchmarkVirtualExecute);
+		registry.add("RenderCommands/Execute/Stream", benchmarkStreamExecute);
+	}
+}
@@ -0,0 +1,60 @@
+#include "benchmarks.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "thread_safe_slot.hpp"
+
+namespace spk::Benchmarks
+{
+	namespace
+	{
+		constexpr std::size_t AcquireCount = 1 << 12;
+
+		/** Stand-in for a published snapshot header: a revision and a few counters. */
+		struct Payload
+		{
+			std::uint64_t revision;
+			std::uint64_t counters[3];
+		};
+	}
+
+	void registerThreadSafeSlotBenchmarks(Registry &registry)
+	{
+		registry.add("ThreadSafeSlot/Publish", [](State &state) {
+			ThreadSafeSlot<Payload> slot;
+			std::uint64_t revision = 0;
+			state.run([&] {
+				slot.publish(Payload{.revision = ++revision, .counters = {}});
+			});
+		});
+		registry.add("ThreadSafeSlot/Acquire", [](State &state) {
+			ThreadSafeSlot<Payload> slot;
+			slot.publish(Payload{.revision = 1, .counters = {}});
+			state.run([&] {
+				const ThreadSafeSlot<Payload>::pointer latest = slot.acquireLatest();
+				doNotOptimize(latest->revision);
+			});
+		});
+		registry.add("ThreadSafeSlot/AcquireWhilePublishing", [](State &state) {
+			auto endpoints = ThreadSafeSlot<Payload>::create();
+			endpoints.producer.publish(Payload{.revision = 0, .counters = {}});
+			std::atomic_bool isRunning = true;
+			std::jthread producer([&isRunning, producer = endpoints.producer]() mutable {
+				std::uint64_t revision = 0;
+				while (isRunning.load(std::memory_order_relaxed))
+					producer.publish(Payload{.revision = ++revision, .counters = {}});
+			});
+
+			state.setItemsPerIteration(AcquireCount);
+			state.run([&] {
+				std::uint64_t checksum = 0;
+				for (std::size_t index = 0; index < AcquireCount; ++index)
+					checksum += endpoints.consumer.acquireLatest()->revision;
+				doNotOptimize(checksum);
+			});
+			isRunning = false;
+		});
+	}
+}
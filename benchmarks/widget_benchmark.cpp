@@ -0,0 +1,226 @@
+#include "benchmarks.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "inherence_trait.hpp"
+#include "mouse.hpp"
+#include "record.hpp"
+#include "render_command_arena.hpp"
+#include "render_snapshot.hpp"
+#include "widget.hpp"
+#include "widget_spatial_index.hpp"
+
+namespace spk::Benchmarks
+{
+	namespace
+	{
+		constexpr std::size_t WideChildCount = 1024;
+		constexpr std::size_t DeepDepth = 64;
+
+		/** Bare InherenceTrait user, so addChild is measured without the widget's parent-edition callbacks. */
+		class Node final : public InherenceTrait<Node>
+		{
+		};
+
+		class CountingWidget final : public Widget
+		{
+		private:
+			std::uint64_t _moveCount = 0;
+
+			void _onMouseMovedEvent(MouseMovedEvent &event) override
+			{
+				_moveCount += static_cast<std::uint64_t>(event.record.position.x);
+			}
+
+		public:
+			using Widget::Widget;
+
+			[[nodiscard]] std::uint64_t moveCount() const noexcept
+			{
+				return _moveCount;
+			}
+		};
+
+		/** Owns a widget tree; widgets are destroyed leaves first, as an application tears its windows down. */
+		class Tree
+		{
+		private:
+			std::vector<std::unique_ptr<CountingWidget>> _widgets;
+
+		public:
+			Tree() = default;
+			Tree(const Tree &) = delete;
+			Tree &operator=(const Tree &) = delete;
+
+			~Tree()
+			{
+				while (!_widgets.empty())
+					_widgets.pop_back();
+			}
+
+			CountingWidget &add(Widget *parent, const Rect2D &geometry)
+			{
+				auto widget = std::make_unique<CountingWidget>("widget" + std::to_string(_widgets.size()), parent);
+				widget->setGeometry(geometry);
+				widget->activate();
+				_widgets.push_back(std::move(widget));
+				return *_widgets.back();
+			}
+
+			[[nodiscard]] CountingWidget &root()
+			{
+				return *_widgets.front();
+			}
+
+			/** The widget added last: the deepest one of a deep tree, a leaf of a wide one. */
+			[[nodiscard]] CountingWidget &last()
+			{
+				return *_widgets.back();
+			}
+
+			[[nodiscard]] std::size_t size() const noexcept
+			{
+				return _widgets.size();
+			}
+
+			void markAllRenderDirty()
+			{
+				for (const auto &widget : _widgets)
+					widget->markRenderDirty();
+			}
+		};
+
+		[[nodiscard]] Rect2D makeGeometry(int x, int y, unsigned int width, unsigned int height)
+		{
+			Rect2D result;
+			result.anchor = {x, y};
+			result.size = {width, height};
+			return result;
+		}
+
+		void buildWideTree(Tree &tree)
+		{
+			CountingWidget &root = tree.add(nullptr, makeGeometry(0, 0, 1024, 1024));
+			for (std::size_t index = 0; index < WideChildCount; ++index)
+			{
+				const int x = static_cast<int>(index % 32) * 32;
+				const int y = static_cast<int>(index / 32) * 32;
+				tree.add(&root, makeGeometry(x, y, 32, 32));
+			}
+		}
+
+		void buildDeepTree(Tree &tree)
+		{
+			Widget *parent = nullptr;
+			for (std::size_t depth = 0; depth < DeepDepth; ++depth)
+			{
+				const unsigned int size = static_cast<unsigned int>(2 * (DeepDepth - depth) + 2);
+				parent = &tree.add(parent, makeGeometry(parent != nullptr ? 1 : 0, parent != nullptr ? 1 : 0, size, size));
+			}
+		}
+
+		void benchmarkDispatch(State &state, void (*build)(Tree &), bool isSpatiallyIndexed)
+		{
+			Tree tree;
+			build(tree);
+			std::unique_ptr<WidgetSpatialIndex> spatialIndex;
+			if (isSpatiallyIndexed)
+				spatialIndex = std::make_unique<WidgetSpatialIndex>(tree.root());
+			Mouse mouse;
+			mouse.position = {1, 1};
+			MouseMovedRecord record;
+			record.position = {1, 1};
+
+			// One item per event: routed and propagated dispatches visit different numbers of widgets.
+			state.run([&] {
+				MouseMovedEvent event(record, mouse);
+				tree.root().dispatch(event);
+			});
+			doNotOptimize(tree.root().moveCount());
+		}
+
+		template <typename TPreparation>
+		void benchmarkSnapshotBuild(State &state, void (*build)(Tree &), TPreparation prepare)
+		{
+			Tree tree;
+			build(tree);
+			auto commandPool = std::make_shared<RenderCommandArena::Pool>();
+			auto fragmentPool = std::make_shared<RenderCommandArena::Pool>(RenderSnapshot::Fragment::DefaultChunkSize);
+			RenderSnapshot snapshot;
+			std::uint64_t revision = 0;
+
+			state.setItemsPerIteration(tree.size());
+			state.run([&] {
+				prepare(tree);
+				RenderSnapshot::Builder builder(commandPool, fragmentPool);
+				tree.root().buildRenderSnapshot(builder);
+				builder.build(snapshot, ++revision);
+			});
+			doNotOptimize(snapshot.revision());
+		}
+	}
+
+	void registerWidgetBenchmarks(Registry &registry)
+	{
+		registry.add("InherenceTrait/AttachDetach/Node/" + std::to_string(WideChildCount), [](State &state) {
+			Node root;
+			std::vector<Node> children(WideChildCount);
+			state.setItemsPerIteration(WideChildCount);
+			state.run([&] {
+				for (Node &child : children)
+					root.addChild(&child);
+				for (Node &child : children)
+					child.setParent(nullptr);
+			});
+		});
+		registry.add("InherenceTrait/AttachDetach/Widget/" + std::to_string(WideChildCount), [](State &state) {
+			Tree tree;
+			CountingWidget &root = tree.add(nullptr, makeGeometry(0, 0, 1024, 1024));
+			std::vector<CountingWidget *> children;
+			for (std::size_t index = 0; index < WideChildCount; ++index)
+			{
+				children.push_back(&tree.add(&root, makeGeometry(0, 0, 32, 32)));
+				children.back()->setParent(nullptr);
+			}
+			state.setItemsPerIteration(WideChildCount);
+			state.run([&] {
+				for (CountingWidget *child : children)
+					root.addChild(child);
+				for (CountingWidget *child : children)
+					child->setParent(nullptr);
+			});
+		});
+
+		registry.add("Widget/Dispatch/Wide", [](State &state) {
+			benchmarkDispatch(state, &buildWideTree, false);
+		});
+		registry.add("Widget/Dispatch/Deep", [](State &state) {
+			benchmarkDispatch(state, &buildDeepTree, false);
+		});
+		registry.add("Widget/Dispatch/Wide/SpatialIndex", [](State &state) {
+			benchmarkDispatch(state, &buildWideTree, true);
+		});
+		registry.add("Widget/Dispatch/Deep/SpatialIndex", [](State &state) {
+			benchmarkDispatch(state, &buildDeepTree, true);
+		});
+
+		registry.add("RenderSnapshot/Build/Wide/AllDirty", [](State &state) {
+			benchmarkSnapshotBuild(state, &buildWideTree, [](Tree &tree) { tree.markAllRenderDirty(); });
+		});
+		registry.add("RenderSnapshot/Build/Deep/AllDirty", [](State &state) {
+			benchmarkSnapshotBuild(state, &buildDeepTree, [](Tree &tree) { tree.markAllRenderDirty(); });
+		});
+		registry.add("RenderSnapshot/Build/Deep/LeafDirty", [](State &state) {
+			benchmarkSnapshotBuild(state, &buildDeepTree, [](Tree &tree) { tree.last().markRenderDirty(); });
+		});
+		registry.add("RenderSnapshot/Build/Wide/LeafDirty", [](State &state) {
+			benchmarkSnapshotBuild(state, &buildWideTree, [](Tree &tree) { tree.last().markRenderDirty(); });
+		});
+		registry.add("RenderSnapshot/Build/Wide/Clean", [](State &state) {
+			benchmarkSnapshotBuild(state, &buildWideTree, [](Tree &) {});
+		});
+	}
+}
@@ -1,18 +1,61 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdlib>
 #include <memory>
+#include <vector>
 
+#include "frame_pacer.hpp"
+#include "job_system.hpp"
+#include "record.hpp"
+#include "render_snapshot.hpp"
+#include "spsc_fifo.hpp"
+#include "wake_signal.hpp"
 #include "window.hpp"
 
 namespace spk
 {
+	class EventRecordWriter;
+
 	class Application
 	{
+	public:
+		static constexpr std::size_t DefaultEventChannelCapacity = 4096;
+
+		enum class SchedulingMode
+		{
+			Spinning,
+			EventDriven
+		};
+
+		struct Configuration
+		{
+			SchedulingMode schedulingMode = SchedulingMode::EventDriven;
+			spk::FramePacer::Configuration pacing;
+			/** Both run as jobs of the application's JobSystem, sized by jobWorkerCount, instead of owning threads. */
+			bool parallelSnapshotBuild = false;
+			std::size_t snapshotBuildGranularity = spk::RenderSnapshot::Builder::DefaultParallelGranularity;
+			bool parallelWindowUpdate = false;
+			std::size_t jobWorkerCount = spk::JobSystem::defaultWorkerCount();
+			/**
+			 * Records the platform may queue ahead of the updater. Once full, one mouse move or resize is held back behind
+			 * the queue and replaced by later ones of the same window and type; any other record waits for the updater.
+			 */
+			std::size_t eventChannelCapacity = DefaultEventChannelCapacity;
+		};
+
+		struct WakeStatistics
+		{
+			spk::WakeSignal::Statistics updater;
+			spk::WakeSignal::Statistics renderer;
+		};
+
+		using EventChannelStatistics = spk::SPSCFIFO<EventRecord>::Statistics;
+
 	private:
 		struct Channels;
 
-		template <typename TType>
+		template <typename TType, typename TEntry>
 		class Runtime;
 
 		class PlatformRuntime;
@@ -24,6 +67,7 @@ namespace spk
 
 	public:
 		Application();
+		explicit Application(const Configuration &configuration);
 		Application(const Application &) = delete;
 		Application(Application &&) = delete;
 		~Application();
@@ -36,6 +80,14 @@ namespace spk
 		Window &createWindow(const Window::Identifier &identifier, const Window::Configuration &configuration);
 		void closeWindow(const Window::Identifier &identifier);
 		void quit(int exitCode = EXIT_SUCCESS);
+		void inject(EventRecord record);
+		void inject(std::vector<EventRecord> records);
+		/** Every record forwarded to the updater from then on, platform or injected, is also written to writer. */
+		void startRecording(std::shared_ptr<EventRecordWriter> writer);
+		void stopRecording();
 		int run();
+
+		[[nodiscard]] WakeStatistics wakeStatistics() const;
+		[[nodiscard]] EventChannelStatistics eventChannelStatistics() const;
 	};
 }
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <optional>
+#include <span>
 
 #include "focus_mode.hpp"
 
@@ -25,8 +26,11 @@ namespace spk
 	struct Event : public EventBase
 	{
 		const TRecordType &record;
+		/** Raw records merged into record by the updater, oldest first. A record that was not coalesced is its own history. */
+		std::span<const TRecordType> history;
 
-		explicit Event(const TRecordType &record) : record(record) {}
+		explicit Event(const TRecordType &record) : record(record), history(&record, 1) {}
+		Event(const TRecordType &record, std::span<const TRecordType> history) : record(record), history(history) {}
 	};
 
 	template <typename TRecordType, typename TDevice>
@@ -35,5 +39,10 @@ namespace spk
 		const TDevice &device;
 
 		DeviceEvent(const TRecordType &record, const TDevice &device) : Event<TRecordType>(record), device(device) {}
+		DeviceEvent(const TRecordType &record, std::span<const TRecordType> history, const TDevice &device) :
+			Event<TRecordType>(record, history),
+			device(device)
+		{
+		}
 	};
 }
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stop_token>
+
+#include "record.hpp"
+
+namespace spk
+{
+	class Application;
+
+	class EventRecordWriter final
+	{
+		/**
+		 * Serialises EventRecords into a compact binary stream: a magic header, then per record its type, its window
+		 * handle, its timestamp as a varint delta from the previous record and its fixed-size payload. Values are
+		 * written in the host byte order. The Application writes from its platform thread once recording is started;
+		 * flush may be called from any thread.
+		 */
+	private:
+		mutable std::mutex _mutex;
+		std::ostream &_stream;
+		BaseEventRecord::Clock::time_point _previousTimestamp;
+		std::uint64_t _recordCount = 0;
+
+		void _write(const EventRecord &record);
+
+	public:
+		explicit EventRecordWriter(std::ostream &stream);
+		EventRecordWriter(const EventRecordWriter &) = delete;
+		EventRecordWriter &operator=(const EventRecordWriter &) = delete;
+
+		void write(const EventRecord &record);
+		void write(std::span<const EventRecord> records);
+		void flush();
+
+		[[nodiscard]] std::uint64_t recordCount() const;
+	};
+
+	class EventRecordReader final
+	{
+		/** Reads back a stream produced by EventRecordWriter; throws std::runtime_error on a malformed stream. */
+	private:
+		std::istream &_stream;
+		BaseEventRecord::Clock::time_point _previousTimestamp;
+
+	public:
+		explicit EventRecordReader(std::istream &stream);
+
+		[[nodiscard]] std::optional<EventRecord> read();
+	};
+
+	class EventRecordReplayer final
+	{
+		/**
+		 * Injects a recorded stream into an Application, typically a headless one, from a thread other than the one
+		 * running it. Records keep the window handles they were recorded with, which match as long as the windows are
+		 * created in the same order, and are restamped on the replay clock so the latency statistics stay meaningful.
+		 */
+	public:
+		enum class Speed
+		{
+			AsFastAsPossible,
+			Original
+		};
+
+		static constexpr std::size_t BatchSize = 256;
+
+		EventRecordReplayer() = delete;
+
+		/** Returns the number of records injected, which is lower than recorded if stopToken was triggered. */
+		static std::uint64_t replay(Application &application, EventRecordReader &reader, Speed speed, std::stop_token stopToken = {});
+	};
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+namespace spk
+{
+	class FramePacer
+	{
+		/**
+		 * The update methods (beginUpdate, nextUpdateDeadline) belong to the updater thread and the render methods
+		 * (isRenderDue, markRendered, nextRenderDeadline) to the renderer thread. Both halves only share the
+		 * immutable configuration, so no synchronisation is required as long as each side keeps to its own thread.
+		 */
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		enum class Mode
+		{
+			FixedStep,
+			OnDemand,
+			Unlimited
+		};
+
+		struct Configuration
+		{
+			Mode mode = Mode::FixedStep;
+			double updateRate = 60.0;
+			std::size_t maxCatchUpSteps = 5;
+			std::optional<double> renderRate = std::nullopt;
+		};
+
+		struct UpdateCycle
+		{
+			std::size_t stepCount = 0;
+			Clock::duration startTime = Clock::duration::zero();
+			Clock::duration deltaTime = Clock::duration::zero();
+			float alpha = 0.0f;
+		};
+
+	private:
+		Configuration _configuration;
+		Clock::duration _updatePeriod;
+		std::optional<Clock::duration> _renderPeriod;
+
+		std::optional<Clock::time_point> _lastUpdateTime;
+		Clock::duration _accumulator = Clock::duration::zero();
+		Clock::duration _simulatedTime = Clock::duration::zero();
+		std::optional<Clock::time_point> _nextUpdateTime;
+
+		std::optional<Clock::time_point> _nextRenderTime;
+
+		[[nodiscard]] static Clock::duration _period(double rate);
+
+		[[nodiscard]] UpdateCycle _beginFixedStep(Clock::time_point now);
+		[[nodiscard]] UpdateCycle _beginVariableStep(Clock::time_point now, std::size_t stepCount);
+
+	public:
+		FramePacer();
+		explicit FramePacer(const Configuration &configuration);
+
+		[[nodiscard]] const Configuration &configuration() const noexcept;
+
+		[[nodiscard]] UpdateCycle beginUpdate(Clock::time_point now, bool hasPendingInput);
+		[[nodiscard]] std::optional<Clock::time_point> nextUpdateDeadline() const noexcept;
+
+		[[nodiscard]] bool isRenderDue(Clock::time_point now) const noexcept;
+		void markRendered(Clock::time_point now) noexcept;
+		[[nodiscard]] std::optional<Clock::time_point> nextRenderDeadline() const noexcept;
+	};
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "rect2d.hpp"
+
+namespace spk::Headless
+{
+	class Frame final
+	{
+		/**
+		 * Virtual counterpart of WinAPI::Frame: it owns no native resource and only remembers the geometry it was
+		 * created with. Later resizes are driven by the WindowResizedRecords injected into the application.
+		 */
+	public:
+		struct CreationInfo
+		{
+			std::string title;
+			int x = 0;
+			int y = 0;
+			std::uint32_t width = 1280;
+			std::uint32_t height = 720;
+		};
+
+	private:
+		bool _isCreated = false;
+		std::string _title;
+		spk::Rect2D _geometry;
+
+	public:
+		Frame() = default;
+		Frame(const Frame &) = delete;
+		Frame(Frame &&) = delete;
+		~Frame() = default;
+
+		Frame &operator=(const Frame &) = delete;
+		Frame &operator=(Frame &&) = delete;
+
+		void create(const CreationInfo &info);
+		void destroy() noexcept;
+		[[nodiscard]] bool isCreated() const noexcept;
+		[[nodiscard]] const std::string &title() const noexcept;
+
+		[[nodiscard]] spk::Rect2D geometry() const;
+	};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+
+namespace spk::Headless
+{
+	class WakeEvent final
+	{
+		/**
+		 * eventfd based counterpart of WinAPI::WakeEvent. It auto-resets like its WinAPI sibling: a wait consumes every
+		 * notification raised since the previous one.
+		 */
+	private:
+		int _descriptor = -1;
+
+		[[noreturn]] static void _throwLastError(const char *operation)
+		{
+			throw std::system_error(errno, std::generic_category(), operation);
+		}
+
+		void _reset() const
+		{
+			std::uint64_t counter = 0;
+			if (::read(_descriptor, &counter, sizeof(counter)) < 0 && errno != EAGAIN)
+				_throwLastError("read");
+		}
+
+	public:
+		WakeEvent()
+		{
+			_descriptor = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+			if (_descriptor < 0)
+				_throwLastError("eventfd");
+		}
+
+		WakeEvent(const WakeEvent &) = delete;
+		WakeEvent(WakeEvent &&) = delete;
+		~WakeEvent() { ::close(_descriptor); }
+
+		WakeEvent &operator=(const WakeEvent &) = delete;
+		WakeEvent &operator=(WakeEvent &&) = delete;
+
+		void notify() const
+		{
+			const std::uint64_t increment = 1;
+			if (::write(_descriptor, &increment, sizeof(increment)) < 0 && errno != EAGAIN)
+				_throwLastError("write");
+		}
+
+		void wait() const
+		{
+			pollfd descriptor{.fd = _descriptor, .events = POLLIN, .revents = 0};
+			while (::poll(&descriptor, 1, -1) < 0)
+			{
+				if (errno != EINTR)
+					_throwLastError("poll");
+			}
+			_reset();
+		}
+
+		[[nodiscard]] int handle() const noexcept { return _descriptor; }
+	};
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spk
+{
+	class JobSystem final
+	{
+		/**
+		 * Work-stealing scheduler for fork-join work spawned from the update and render threads. Every worker owns a deque: it
+		 * pushes and pops its own jobs at the back and steals from the front of the others' when it runs dry, while
+		 * jobs spawned from outside the workers go through a shared injection queue. A thread waiting on a TaskGroup
+		 * runs pending jobs itself until the group completes, so waiting never idles a thread and a JobSystem without
+		 * workers, or one that is stopped, still executes everything on the waiting thread.
+		 */
+	public:
+		using Job = std::function<void()>;
+		using RangeJob = std::function<void(std::size_t begin, std::size_t end)>;
+
+		static constexpr std::size_t DefaultGranularity = 64;
+
+		class TaskGroup
+		{
+			/** Set of jobs joined together; the destructor waits for any job still in flight. */
+		private:
+			JobSystem &_system;
+			std::atomic<std::size_t> _pendingCount = 0;
+			std::mutex _exceptionMutex;
+			std::exception_ptr _exception = nullptr;
+
+			friend class JobSystem;
+
+			void _complete(std::exception_ptr exception);
+
+		public:
+			explicit TaskGroup(JobSystem &system);
+			TaskGroup(const TaskGroup &) = delete;
+			TaskGroup(TaskGroup &&) = delete;
+			~TaskGroup();
+
+			TaskGroup &operator=(const TaskGroup &) = delete;
+			TaskGroup &operator=(TaskGroup &&) = delete;
+
+			void run(Job job);
+			/** Rethrows the first exception thrown by a job of the group, once all of them are done. */
+			void wait();
+		};
+
+	private:
+		struct Task
+		{
+			Job job;
+			TaskGroup *group = nullptr;
+		};
+
+		struct Worker
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		std::size_t _workerCount;
+		std::vector<std::unique_ptr<Worker>> _workers;
+		std::vector<std::jthread> _threads;
+		std::mutex _injectionMutex;
+		std::deque<Task> _injectedTasks;
+		std::atomic<std::size_t> _queuedCount = 0;
+		std::mutex _sleepMutex;
+		std::condition_variable _sleepCondition;
+		bool _isStopping = false;
+
+		[[nodiscard]] Worker *_currentWorker() const noexcept;
+		void _push(Task task);
+		[[nodiscard]] bool _tryPop(Task &task, const Worker *worker);
+		[[nodiscard]] bool _tryRunOne(const Worker *worker);
+		void _execute(Task &task);
+		void _notifyAll();
+		void _work(std::size_t index);
+		void _waitFor(const TaskGroup &group);
+
+	public:
+		/** Sized after the hardware, leaving one hardware thread to the update thread that joins the jobs. */
+		[[nodiscard]] static std::size_t defaultWorkerCount() noexcept;
+
+		explicit JobSystem(std::size_t workerCount = defaultWorkerCount());
+		JobSystem(const JobSystem &) = delete;
+		JobSystem(JobSystem &&) = delete;
+		~JobSystem();
+
+		JobSystem &operator=(const JobSystem &) = delete;
+		JobSystem &operator=(JobSystem &&) = delete;
+
+		void start();
+		void stop();
+
+		[[nodiscard]] bool isRunning() const noexcept;
+		[[nodiscard]] std::size_t workerCount() const noexcept;
+
+		/** Splits [0, count) into ranges of at most granularity indexes, runs them as jobs and returns once all are done. */
+		void parallelFor(std::size_t count, const RangeJob &job, std::size_t granularity = DefaultGranularity);
+	};
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace spk
+{
+	class LatencyHistogram final
+	{
+		/**
+		 * Log-linear histogram of durations in nanoseconds: every power of two is split into eight linear buckets,
+		 * so a percentile is reported within 12.5% of the recorded value whatever its magnitude. Recording is a
+		 * couple of relaxed atomic increments, letting one thread record while others read summaries.
+		 */
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Summary
+		{
+			std::uint64_t count = 0;
+			Clock::duration p50 = Clock::duration::zero();
+			Clock::duration p95 = Clock::duration::zero();
+			Clock::duration p99 = Clock::duration::zero();
+			Clock::duration maximum = Clock::duration::zero();
+		};
+
+	private:
+		static constexpr std::size_t SubBucketBits = 3;
+		static constexpr std::size_t SubBucketCount = std::size_t(1) << SubBucketBits;
+		static constexpr std::size_t BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+		std::array<std::atomic<std::uint64_t>, BucketCount> _buckets{};
+		std::atomic<std::uint64_t> _count = 0;
+		std::atomic<std::uint64_t> _maximum = 0;
+
+		[[nodiscard]] static std::size_t _index(std::uint64_t value) noexcept
+		{
+			if (value < SubBucketCount)
+			{
+				return static_cast<std::size_t>(value);
+			}
+			const std::size_t exponent = static_cast<std::size_t>(std::bit_width(value)) - 1;
+			const std::size_t subBucket = static_cast<std::size_t>(value >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+			return (exponent - SubBucketBits + 1) * SubBucketCount + subBucket;
+		}
+
+		[[nodiscard]] static std::uint64_t _upperBound(std::size_t index) noexcept
+		{
+			if (index < SubBucketCount)
+			{
+				return index;
+			}
+			const std::size_t exponent = index / SubBucketCount + SubBucketBits - 1;
+			const std::uint64_t width = std::uint64_t(1) << (exponent - SubBucketBits);
+			return (SubBucketCount + index % SubBucketCount) * width + width - 1;
+		}
+
+	public:
+		void record(Clock::duration duration) noexcept
+		{
+			const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+			const std::uint64_t value = nanoseconds > 0 ? static_cast<std::uint64_t>(nanoseconds) : 0;
+
+			_buckets[_index(value)].fetch_add(1, std::memory_order_relaxed);
+			_count.fetch_add(1, std::memory_order_relaxed);
+			std::uint64_t maximum = _maximum.load(std::memory_order_relaxed);
+			while (value > maximum && !_maximum.compare_exchange_weak(maximum, value, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		[[nodiscard]] std::uint64_t count() const noexcept
+		{
+			return _count.load(std::memory_order_relaxed);
+		}
+
+		/** Upper bound of the bucket holding the given quantile, in [0, 1], clamped to the largest recorded value. */
+		[[nodiscard]] Clock::duration percentile(double quantile) const noexcept
+		{
+			const std::uint64_t count = this->count();
+			if (count == 0)
+			{
+				return Clock::duration::zero();
+			}
+
+			const double clampedQuantile = std::clamp(quantile, 0.0, 1.0);
+			const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(clampedQuantile * static_cast<double>(count) + 0.5));
+			const std::uint64_t maximum = _maximum.load(std::memory_order_relaxed);
+			std::uint64_t accumulated = 0;
+			for (std::size_t index = 0; index < BucketCount; ++index)
+			{
+				accumulated += _buckets[index].load(std::memory_order_relaxed);
+				if (accumulated >= rank)
+				{
+					return std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(std::min(_upperBound(index), maximum)));
+				}
+			}
+			return std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(maximum));
+		}
+
+		[[nodiscard]] Summary summary() const noexcept
+		{
+			return Summary{
+				.count = count(),
+				.p50 = percentile(0.50),
+				.p95 = percentile(0.95),
+				.p99 = percentile(0.99),
+				.maximum = std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(_maximum.load(std::memory_order_relaxed)))};
+		}
+	};
+}
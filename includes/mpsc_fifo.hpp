@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ranges>
+#include <span>
+#include <stop_token>
+#include <utility>
+#include <vector>
+
+namespace spk
+{
+	template <typename TValue>
+	class MPSCFIFO final
+	{
+		/**
+		 * Multi-producer, single-consumer counterpart of ThreadSafeFIFO, built as a linked queue of segments. Each
+		 * publish call stores its values inline in one segment, so a batch costs one allocation, and links it with a
+		 * single atomic exchange on the tail; the consumer is only signalled when it is actually blocked in wait.
+		 * Values linked by one producer are drained in the order they were published.
+		 */
+	public:
+		using value_type = TValue;
+		using container_type = std::vector<value_type>;
+
+	private:
+		struct Segment
+		{
+			// The values of one publish call are stored inline, right after these members.
+			static constexpr std::size_t Alignment = std::max(alignof(std::max_align_t), alignof(value_type));
+			static constexpr std::size_t ValueOffset = (sizeof(std::atomic<Segment *>) + sizeof(std::size_t) + alignof(value_type) - 1) /
+													   alignof(value_type) * alignof(value_type);
+
+			std::atomic<Segment *> next = nullptr;
+			std::size_t count = 0;
+
+			[[nodiscard]] value_type *values() noexcept
+			{
+				return reinterpret_cast<value_type *>(reinterpret_cast<std::byte *>(this) + ValueOffset);
+			}
+
+			[[nodiscard]] static Segment *allocate(std::size_t capacity)
+			{
+				void *memory = ::operator new(ValueOffset + capacity * sizeof(value_type), std::align_val_t(Alignment));
+				return ::new (memory) Segment();
+			}
+
+			static void release(Segment *segment) noexcept
+			{
+				std::destroy_n(segment->values(), segment->count);
+				segment->~Segment();
+				::operator delete(segment, std::align_val_t(Alignment));
+			}
+		};
+
+		/** Owns a segment until it is linked, destroying what was constructed if a value constructor throws. */
+		class PendingSegment
+		{
+		private:
+			Segment *_segment;
+
+		public:
+			explicit PendingSegment(std::size_t capacity) :
+				_segment(Segment::allocate(capacity))
+			{
+			}
+
+			PendingSegment(const PendingSegment &) = delete;
+			PendingSegment &operator=(const PendingSegment &) = delete;
+
+			~PendingSegment()
+			{
+				if (_segment != nullptr)
+				{
+					Segment::release(_segment);
+				}
+			}
+
+			template <typename... TArguments>
+			void emplace(TArguments &&...arguments)
+			{
+				std::construct_at(_segment->values() + _segment->count, std::forward<TArguments>(arguments)...);
+				++_segment->count;
+			}
+
+			[[nodiscard]] Segment *release() noexcept
+			{
+				return std::exchange(_segment, nullptr);
+			}
+		};
+
+		struct State
+		{
+			static constexpr std::size_t CacheLineSize = 64;
+
+			alignas(CacheLineSize) std::atomic<Segment *> tail;
+			alignas(CacheLineSize) Segment *head;
+			alignas(CacheLineSize) std::atomic<bool> isConsumerWaiting = false;
+			std::mutex mutex;
+			std::condition_variable_any condition;
+
+			State() :
+				tail(Segment::allocate(0)),
+				head(tail.load(std::memory_order_relaxed))
+			{
+			}
+
+			State(const State &) = delete;
+			State &operator=(const State &) = delete;
+
+			~State()
+			{
+				while (head != nullptr)
+				{
+					Segment *next = head->next.load(std::memory_order_acquire);
+					Segment::release(head);
+					head = next;
+				}
+			}
+
+			void link(PendingSegment &pending)
+			{
+				Segment *segment = pending.release();
+				if (segment->count == 0)
+				{
+					Segment::release(segment);
+					return;
+				}
+
+				Segment *previous = tail.exchange(segment, std::memory_order_acq_rel);
+				previous->next.store(segment, std::memory_order_seq_cst);
+
+				if (isConsumerWaiting.load(std::memory_order_seq_cst))
+				{
+					{
+						const std::scoped_lock lock(mutex);
+					}
+					condition.notify_one();
+				}
+			}
+
+			template <typename... TArguments>
+			void emplace(TArguments &&...arguments)
+			{
+				PendingSegment pending(1);
+				pending.emplace(std::forward<TArguments>(arguments)...);
+				link(pending);
+			}
+
+			template <typename TRange>
+			void emplaceRange(TRange &&range)
+			{
+				if constexpr (std::ranges::sized_range<TRange>)
+				{
+					PendingSegment pending(std::ranges::size(range));
+					for (auto &&element : range)
+					{
+						pending.emplace(std::forward<decltype(element)>(element));
+					}
+					link(pending);
+				}
+				else
+				{
+					for (auto &&element : range)
+					{
+						emplace(std::forward<decltype(element)>(element));
+					}
+				}
+			}
+
+			void publishBatch(std::span<value_type> values)
+			{
+				PendingSegment pending(values.size());
+				for (value_type &value : values)
+				{
+					pending.emplace(std::move(value));
+				}
+				link(pending);
+			}
+
+			[[nodiscard]] bool isEmpty() const noexcept
+			{
+				return head->next.load(std::memory_order_seq_cst) == nullptr;
+			}
+
+			[[nodiscard]] bool wait(std::stop_token stopToken)
+			{
+				if (!isEmpty())
+				{
+					return true;
+				}
+
+				std::unique_lock lock(mutex);
+				isConsumerWaiting.store(true, std::memory_order_seq_cst);
+				const bool result = condition.wait(
+					lock,
+					stopToken,
+					[this] {
+						return !isEmpty();
+					});
+				isConsumerWaiting.store(false, std::memory_order_relaxed);
+				return result;
+			}
+
+			[[nodiscard]] container_type &drain(container_type &toFill)
+			{
+				toFill.clear();
+
+				// A producer may have swapped the tail without linking its segment yet; its values are picked up by the
+				// next drain, and the producer wakes the consumer once they are reachable.
+				Segment *next = head->next.load(std::memory_order_acquire);
+				while (next != nullptr)
+				{
+					std::move(next->values(), next->values() + next->count, std::back_inserter(toFill));
+					Segment::release(std::exchange(head, next));
+					next = head->next.load(std::memory_order_acquire);
+				}
+
+				return toFill;
+			}
+		};
+
+		std::shared_ptr<State> _state;
+
+	public:
+		class Producer
+		{
+		private:
+			std::shared_ptr<State> _state;
+
+			explicit Producer(std::shared_ptr<State> state) :
+				_state(std::move(state))
+			{
+			}
+
+			friend class MPSCFIFO;
+
+		public:
+			void publish(value_type value)
+			{
+				_state->emplace(std::move(value));
+			}
+
+			template <typename... TArguments>
+			void emplace(TArguments &&...arguments)
+			{
+				_state->emplace(std::forward<TArguments>(arguments)...);
+			}
+
+			/** Moves every value out of values and links them with a single atomic operation. */
+			void publishBatch(std::span<value_type> values)
+			{
+				_state->publishBatch(values);
+			}
+
+			template <std::ranges::input_range TRange>
+			void emplaceRange(TRange &&range)
+			{
+				_state->emplaceRange(std::forward<TRange>(range));
+			}
+		};
+
+		class Consumer
+		{
+		private:
+			std::shared_ptr<State> _state;
+			container_type _values;
+
+			explicit Consumer(std::shared_ptr<State> state) :
+				_state(std::move(state))
+			{
+			}
+
+			friend class MPSCFIFO;
+
+		public:
+			Consumer(const Consumer &) = delete;
+			Consumer(Consumer &&) = default;
+
+			Consumer &operator=(const Consumer &) = delete;
+			Consumer &operator=(Consumer &&) = default;
+
+			[[nodiscard]] bool wait(std::stop_token stopToken = {})
+			{
+				return _state->wait(stopToken);
+			}
+
+			[[nodiscard]] container_type &drain()
+			{
+				return _state->drain(_values);
+			}
+		};
+
+		struct Endpoints
+		{
+			Producer producer;
+			Consumer consumer;
+		};
+
+		[[nodiscard]] static Endpoints create()
+		{
+			auto state = std::make_shared<State>();
+
+			return {
+				.producer = Producer(state),
+				.consumer = Consumer(std::move(state))};
+		}
+	};
+}
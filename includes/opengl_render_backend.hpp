@@ -0,0 +1,22 @@
+#pragma once
+
+#include "render_backend.hpp"
+
+namespace spk
+{
+	class OpenGLRenderBackend final : public RenderBackend
+	{
+	private:
+		spk::Vector2UInt _frameSize;
+
+		[[nodiscard]] int _flippedY(const spk::Rect2D &area) const noexcept;
+
+	public:
+		void execute(const RenderPass &pass, RenderContext &renderContext) override;
+		void beginFrame(const spk::Vector2UInt &size) override;
+		void setViewport(const spk::Rect2D &viewport) override;
+		void setScissor(const spk::Rect2D &scissor) override;
+		void clear(const spk::Color &color, ClearRenderCommand::Mask mask) override;
+		void endFrame() override;
+	};
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#if !defined(SPARKLE_PLATFORM_WINAPI) && !defined(SPARKLE_PLATFORM_HEADLESS)
+#define SPARKLE_PLATFORM_WINAPI
+#endif
+
+namespace spk
+{
+	namespace WinAPI
+	{
+		class Frame;
+		class WakeEvent;
+	}
+
+	namespace Headless
+	{
+		class Frame;
+		class WakeEvent;
+	}
+
+#if defined(SPARKLE_PLATFORM_HEADLESS)
+	namespace Platform = Headless;
+#else
+	namespace Platform = WinAPI;
+#endif
+}
@@ -7,17 +7,25 @@
 
 namespace spk
 {
+	class EventRecordWriter;
+
 	struct NativeRegistrationRequest
 	{
-		Window::Identifier windowIdentifier;
+		WindowHandle windowHandle;
 		Window::Configuration configuration;
 		std::shared_ptr<Window::Native> native;
 	};
 
 	struct NativeDeletionRequest
 	{
-		Window::Identifier windowIdentifier;
+		WindowHandle windowHandle;
+	};
+
+	/** A null writer stops the current recording. */
+	struct EventRecordingRequest
+	{
+		std::shared_ptr<EventRecordWriter> writer;
 	};
 
-	using PlatformRequest = std::variant<NativeRegistrationRequest, NativeDeletionRequest>;
+	using PlatformRequest = std::variant<NativeRegistrationRequest, NativeDeletionRequest, EventRecordingRequest>;
 }
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace spk
+{
+	class Profiler final
+	{
+		/**
+		 * Collects timed scopes into one single-producer ring buffer per thread and exports them as Chrome trace
+		 * JSON, readable by chrome://tracing and Perfetto. Recording a scope never locks or allocates; a thread whose
+		 * buffer is full drops its new scopes until the next export drains it.
+		 * The SPARKLE_PROFILE_* macros expand to nothing unless SPARKLE_ENABLE_PROFILER is defined, so instrumented
+		 * code costs nothing in regular builds.
+		 */
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		static constexpr std::size_t ThreadCapacity = 1 << 14;
+
+		struct Statistics
+		{
+			std::uint64_t recordedCount = 0;
+			std::uint64_t droppedCount = 0;
+		};
+
+		class Scope
+		{
+		private:
+			const char *_name;
+			Clock::time_point _start;
+
+		public:
+			/** A null name makes the scope inert, which lets optional scopes share the same macro. */
+			explicit Scope(const char *name) noexcept :
+				_name(name),
+				_start(name != nullptr ? Clock::now() : Clock::time_point())
+			{
+			}
+
+			Scope(const Scope &) = delete;
+			Scope &operator=(const Scope &) = delete;
+
+			~Scope()
+			{
+				if (_name != nullptr)
+				{
+					record(_name, _start, Clock::now());
+				}
+			}
+		};
+
+		Profiler() = delete;
+
+		/** name must outlive the profiler: a string literal, or a pointer returned by intern. */
+		static void record(const char *name, Clock::time_point start, Clock::time_point end) noexcept;
+		[[nodiscard]] static const char *intern(std::string_view name);
+		static void setThreadName(std::string_view name);
+
+		static void setWidgetScopesEnabled(bool isEnabled) noexcept;
+		[[nodiscard]] static bool areWidgetScopesEnabled() noexcept;
+
+		/** Drains every thread's buffer into stream; scopes recorded meanwhile are kept for the next export. */
+		static void exportChromeTrace(std::ostream &stream);
+		[[nodiscard]] static Statistics statistics();
+	};
+}
+
+#define SPARKLE_PROFILE_CONCATENATE_IMPLEMENTATION(lhs, rhs) lhs##rhs
+#define SPARKLE_PROFILE_CONCATENATE(lhs, rhs) SPARKLE_PROFILE_CONCATENATE_IMPLEMENTATION(lhs, rhs)
+
+#if defined(SPARKLE_ENABLE_PROFILER)
+#define SPARKLE_PROFILE_SCOPE(name) const ::spk::Profiler::Scope SPARKLE_PROFILE_CONCATENATE(sparkleProfileScope, __LINE__)(name)
+#define SPARKLE_PROFILE_WIDGET_SCOPE(widget) \
+	SPARKLE_PROFILE_SCOPE(::spk::Profiler::areWidgetScopesEnabled() ? (widget).profileName() : nullptr)
+#define SPARKLE_PROFILE_THREAD(name) ::spk::Profiler::setThreadName(name)
+#else
+#define SPARKLE_PROFILE_SCOPE(name) static_cast<void>(0)
+#define SPARKLE_PROFILE_WIDGET_SCOPE(widget) static_cast<void>(0)
+#define SPARKLE_PROFILE_THREAD(name) static_cast<void>(0)
+#endif
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <variant>
 
 #include "event.hpp"
@@ -12,7 +13,11 @@ namespace spk
 {
 	struct BaseEventRecord
 	{
-		Window::Identifier windowIdentifier;
+		using Clock = std::chrono::steady_clock;
+
+		WindowHandle windowHandle;
+		/** When the platform produced the record; injected records left unstamped are stamped as they are forwarded. */
+		Clock::time_point timestamp;
 	};
 
 	struct WindowResizedRecord : public BaseEventRecord
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "clear_render_command.hpp"
+#include "color.hpp"
+#include "rect2d.hpp"
+#include "vector2.hpp"
+
+namespace spk
+{
+	class RenderPass;
+	struct RenderContext;
+
+	class RenderBackend
+	{
+		/**
+		 * Receives the fixed-function state changes issued by the built-in render commands.
+		 * Rectangles are expressed in surface coordinates, with the origin in the top-left corner.
+		 * Implementations of execute are expected to forward to RenderPass::play with their own concrete type,
+		 * so the commands of a pass reach the backend without any further virtual dispatch.
+		 */
+	public:
+		virtual ~RenderBackend() = default;
+
+		virtual void execute(const RenderPass &pass, RenderContext &renderContext) = 0;
+
+		virtual void beginFrame(const spk::Vector2UInt &size) = 0;
+		virtual void setViewport(const spk::Rect2D &viewport) = 0;
+		virtual void setScissor(const spk::Rect2D &scissor) = 0;
+		virtual void clear(const spk::Color &color, ClearRenderCommand::Mask mask) = 0;
+		virtual void endFrame() = 0;
+	};
+}
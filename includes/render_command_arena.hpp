@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace spk
+{
+	class RenderCommandArena final
+	{
+		/**
+		 * Bump allocator backing the render commands of one snapshot. The arena never runs destructors itself:
+		 * the RenderPasses destroy their commands, then the arena hands its chunks back to its pool, if any,
+		 * so the next snapshot of the same window reuses the memory instead of reaching the heap again.
+		 */
+	public:
+		static constexpr std::size_t DefaultChunkSize = 64 * 1024;
+		static constexpr std::size_t DefaultRetainedChunkCount = 64;
+
+		struct Chunk
+		{
+			std::unique_ptr<std::byte[]> memory;
+			std::size_t size = 0;
+		};
+
+		class Pool final
+		{
+		private:
+			mutable std::mutex _mutex;
+			std::vector<Chunk> _chunks;
+			std::size_t _chunkSize;
+			std::size_t _retainedChunkCount;
+
+		public:
+			explicit Pool(std::size_t chunkSize = DefaultChunkSize, std::size_t retainedChunkCount = DefaultRetainedChunkCount);
+
+			[[nodiscard]] std::size_t chunkSize() const noexcept;
+			[[nodiscard]] std::size_t retainedChunks() const;
+
+			[[nodiscard]] Chunk acquire();
+			void release(Chunk &&chunk);
+		};
+
+	private:
+		std::shared_ptr<Pool> _pool;
+		std::vector<Chunk> _chunks;
+		std::size_t _offset = 0;
+		std::size_t _usedBytes = 0;
+
+		[[nodiscard]] std::size_t _chunkSize() const noexcept;
+		[[nodiscard]] Chunk _acquireChunk(std::size_t minimalSize);
+		[[nodiscard]] void *_tryAllocate(std::size_t size, std::size_t alignment) noexcept;
+		[[nodiscard]] void *_allocate(std::size_t size, std::size_t alignment);
+
+	public:
+		RenderCommandArena();
+		explicit RenderCommandArena(std::shared_ptr<Pool> pool);
+		RenderCommandArena(const RenderCommandArena &) = delete;
+		RenderCommandArena(RenderCommandArena &&) = delete;
+		~RenderCommandArena();
+
+		RenderCommandArena &operator=(const RenderCommandArena &) = delete;
+		RenderCommandArena &operator=(RenderCommandArena &&) = delete;
+
+		template <typename TType, typename... TArgs>
+		[[nodiscard]] TType *create(TArgs &&...args)
+		{
+			void *memory = _allocate(sizeof(TType), alignof(TType));
+			return std::construct_at(static_cast<TType *>(memory), std::forward<TArgs>(args)...);
+		}
+
+		[[nodiscard]] const std::shared_ptr<Pool> &pool() const noexcept;
+		[[nodiscard]] std::size_t usedBytes() const noexcept;
+		[[nodiscard]] std::size_t chunkCount() const noexcept;
+	};
+}
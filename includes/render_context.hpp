@@ -4,8 +4,11 @@
 
 namespace spk
 {
+	class RenderBackend;
+
 	struct RenderContext
 	{
 		Window::Surface* targetSurface;
+		RenderBackend* backend;
 	};
-}
\ No newline at end of file
+}
@@ -1,18 +1,34 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <memory>
+#include <cstring>
+#include <optional>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "clear_render_command.hpp"
+#include "color.hpp"
+#include "rect2d.hpp"
+#include "render_backend.hpp"
+#include "render_command.hpp"
+#include "render_command_arena.hpp"
+#include "scissor_render_command.hpp"
+#include "viewport_render_command.hpp"
+
 namespace spk
 {
-	class RenderCommand;
 	struct RenderContext;
 
 	class RenderPass
 	{
+		/**
+		 * Built-in commands are encoded in a packed, tagged byte stream and replayed with a switch straight into the
+		 * concrete backend, so they cost neither an allocation nor a virtual call. Any other command type is placed in
+		 * the arena and recorded in the stream as a pointer, executed through RenderCommand::execute.
+		 */
 	public:
 		using Name = std::string;
 		using Order = std::int32_t;
@@ -23,25 +39,129 @@ namespace spk
 			Order order;
 		};
 
-		RenderPass();
+		/** Viewport and scissor state carried from one pass to the next while eliding redundant state changes. */
+		struct StateTracker
+		{
+			std::optional<Rect2D> appliedViewport;
+			std::optional<Rect2D> appliedScissor;
+			std::optional<Rect2D> pendingViewport;
+			std::optional<Rect2D> pendingScissor;
+		};
+
+	private:
+		enum class Opcode : std::uint8_t
+		{
+			Clear,
+			Viewport,
+			Scissor,
+			Custom
+		};
+
+		struct ClearPayload
+		{
+			Color color;
+			ClearRenderCommand::Mask mask;
+		};
+
+		static_assert(std::is_trivially_copyable_v<ClearPayload>);
+		static_assert(std::is_trivially_copyable_v<Rect2D>);
+
+		RenderCommandArena *_arena;
+		std::vector<std::byte> _stream;
+		std::vector<const RenderCommand *> _customCommands;
+		std::size_t _commandCount = 0;
+
+		template <typename TPayload>
+		void _write(Opcode opcode, const TPayload &payload)
+		{
+			const std::size_t offset = _stream.size();
+			_stream.resize(offset + 1 + sizeof(TPayload));
+			_stream[offset] = static_cast<std::byte>(opcode);
+			std::memcpy(_stream.data() + offset + 1, &payload, sizeof(TPayload));
+			++_commandCount;
+		}
+
+		template <typename TPayload>
+		[[nodiscard]] static TPayload _read(const std::byte *&cursor) noexcept
+		{
+			TPayload result;
+			std::memcpy(&result, cursor, sizeof(TPayload));
+			cursor += sizeof(TPayload);
+			return result;
+		}
+
+		void _appendCustom(const RenderCommand *command);
+		void _flushState(StateTracker &tracker);
+		void _destroyCommands() noexcept;
+
+	public:
+		explicit RenderPass(RenderCommandArena &arena);
 		RenderPass(const RenderPass &) = delete;
-		RenderPass(RenderPass &&) noexcept;
+		RenderPass(RenderPass &&other) noexcept;
 		~RenderPass();
 
 		RenderPass &operator=(const RenderPass &) = delete;
-		RenderPass &operator=(RenderPass &&) noexcept;
+		RenderPass &operator=(RenderPass &&other) noexcept;
 
-		void append(std::unique_ptr<const RenderCommand> renderCommand);
+		void clear(const Color &color, ClearRenderCommand::Mask mask);
+		void setViewport(const Rect2D &viewport);
+		void setScissor(const Rect2D &scissor);
+
+		/** Appends the commands of other without taking ownership of its custom commands, which must outlive this pass. */
+		void append(const RenderPass &other);
 
 		template <typename TCommandType, typename... TArgs>
 		void emplace(TArgs &&...args)
 		{
-			append(std::make_unique<TCommandType>(std::forward<TArgs>(args)...));
+			if constexpr (std::is_same_v<TCommandType, ClearRenderCommand>)
+				clear(std::forward<TArgs>(args)...);
+			else if constexpr (std::is_same_v<TCommandType, ViewportRenderCommand>)
+				setViewport(std::forward<TArgs>(args)...);
+			else if constexpr (std::is_same_v<TCommandType, ScissorRenderCommand>)
+				setScissor(std::forward<TArgs>(args)...);
+			else
+				_appendCustom(_arena->create<TCommandType>(std::forward<TArgs>(args)...));
 		}
 
+		/**
+		 * Rewrites the stream so that viewport and scissor changes are only kept when they differ from the applied
+		 * state and a clear or custom command consumes them. Changes still pending at the end stay in the tracker.
+		 */
+		void elideRedundantState(StateTracker &tracker);
+
+		[[nodiscard]] std::size_t size() const noexcept;
+		[[nodiscard]] std::size_t streamSize() const noexcept;
+
 		void execute(RenderContext &renderContext) const;
 
-	private:
-		std::vector<std::unique_ptr<const RenderCommand>> _commands;
+		template <typename TBackend>
+		void play(TBackend &backend, RenderContext &renderContext) const
+		{
+			const std::byte *cursor = _stream.data();
+			const std::byte *const end = cursor + _stream.size();
+
+			while (cursor != end)
+			{
+				const auto opcode = static_cast<Opcode>(*cursor++);
+				switch (opcode)
+				{
+				case Opcode::Clear:
+				{
+					const auto payload = _read<ClearPayload>(cursor);
+					backend.clear(payload.color, payload.mask);
+					break;
+				}
+				case Opcode::Viewport:
+					backend.setViewport(_read<Rect2D>(cursor));
+					break;
+				case Opcode::Scissor:
+					backend.setScissor(_read<Rect2D>(cursor));
+					break;
+				case Opcode::Custom:
+					_read<const RenderCommand *>(cursor)->execute(renderContext);
+					break;
+				}
+			}
+		}
 	};
 }
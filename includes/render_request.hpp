@@ -4,34 +4,35 @@
 #include <variant>
 
 #include "window.hpp"
-#include "thread_safe_slot.hpp"
 #include "render_snapshot.hpp"
+#include "triple_buffer.hpp"
 
 namespace spk
 {
 	struct SurfaceRegistrationRequest
 	{
-		Window::Identifier windowIdentifier;
+		WindowHandle windowHandle;
 		std::shared_ptr<Window::Surface> surface;
-		spk::ThreadSafeSlot<spk::RenderSnapshot>::Consumer renderSnapshotConsumer;
+		spk::TripleBuffer<spk::RenderSnapshot>::Consumer renderSnapshotConsumer;
 		std::shared_ptr<std::atomic_bool> isRequested;
+		std::shared_ptr<Window::Latency> latency;
 	};
 
 	struct SurfaceCreationRequest
 	{
-		Window::Identifier windowIdentifier;
+		WindowHandle windowHandle;
 		std::weak_ptr<Window::Native> native;
 	};
 
 	struct SurfaceResizeRequest
 	{
-		Window::Identifier windowIdentifier;
+		WindowHandle windowHandle;
 		spk::Vector2UInt newSize;
 	};
 
 	struct SurfaceDeletionRequest
 	{
-		Window::Identifier windowIdentifier;
+		WindowHandle windowHandle;
 	};
 
 	using RenderRequest = std::variant<
@@ -1,17 +1,68 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "render_command_arena.hpp"
 #include "render_pass.hpp"
 
 namespace spk
 {
+	class JobSystem;
+
 	class RenderSnapshot
 	{
 	public:
+		class Builder;
+
+		using Clock = std::chrono::steady_clock;
+
+		struct Timestamps
+		{
+			/** Newest input record dispatched before the snapshot was built, if any arrived since the previous one. */
+			std::optional<Clock::time_point> input;
+			Clock::time_point build;
+		};
+
+		class Fragment
+		{
+			/**
+			 * Immutable recording of the commands emitted for a part of a widget tree: the fragments spliced into it,
+			 * held by reference and played in order, followed by the commands it recorded itself. Splicing never
+			 * copies commands; they are flattened once, when a Builder builds the snapshot. A fragment owns the custom
+			 * commands it recorded, so it can be shared between the widget caching it and every snapshot using it.
+			 */
+		public:
+			static constexpr std::size_t DefaultChunkSize = 1024;
+
+		private:
+			friend class Builder;
+
+			struct Entry
+			{
+				RenderPass::Key key;
+				RenderPass pass;
+			};
+
+			std::vector<std::shared_ptr<const Fragment>> _parts;
+			std::unique_ptr<RenderCommandArena> _arena;
+			std::vector<Entry> _entries;
+
+		public:
+			Fragment(
+				std::vector<std::shared_ptr<const Fragment>> parts,
+				std::unique_ptr<RenderCommandArena> arena,
+				std::vector<Entry> entries);
+
+			[[nodiscard]] std::size_t size() const noexcept;
+		};
+
 		class Builder
 		{
 		private:
@@ -22,28 +73,76 @@ namespace spk
 			};
 
 		public:
+			static constexpr std::size_t DefaultParallelGranularity = 256;
+
 			class InvalidRenderPassKeyError : public std::logic_error
 			{
 			public:
 				using std::logic_error::logic_error;
 			};
 
+			Builder();
+			explicit Builder(std::shared_ptr<RenderCommandArena::Pool> pool);
+			Builder(std::shared_ptr<RenderCommandArena::Pool> pool, std::shared_ptr<RenderCommandArena::Pool> fragmentPool);
+			Builder(const Builder &) = delete;
+			Builder(Builder &&) = delete;
+
+			Builder &operator=(const Builder &) = delete;
+			Builder &operator=(Builder &&) = delete;
+
+			/**
+			 * Lets Widget::buildRenderSnapshot rebuild independent dirty subtrees as jobs of jobSystem. Subtrees are cut
+			 * so that each job covers at most granularity widgets; their fragments are then spliced in tree order, so
+			 * the result is identical to a sequential build.
+			 */
+			void setJobSystem(JobSystem *jobSystem, std::size_t granularity = DefaultParallelGranularity);
+			[[nodiscard]] JobSystem *jobSystem() const noexcept;
+			[[nodiscard]] std::size_t parallelGranularity() const noexcept;
+
 			RenderPass &renderPass(const RenderPass::Key &key);
-			RenderSnapshot build();
+			void splice(const std::shared_ptr<const Fragment> &fragment);
+
+			/** Returns an empty builder recording into fragment-sized chunks, meant to be closed with buildFragment. */
+			[[nodiscard]] Builder recorder() const;
+
+			RenderSnapshot build(std::uint64_t revision = 0);
+			/** Rebuilds target in place, reusing the storage it owns from a previous build. */
+			void build(RenderSnapshot &target, std::uint64_t revision = 0);
+			[[nodiscard]] std::shared_ptr<const Fragment> buildFragment();
 
 		private:
 			[[nodiscard]] PendingPass *findPass(const std::string &name);
+			[[nodiscard]] std::shared_ptr<const Fragment> _seal(std::vector<std::shared_ptr<const Fragment>> parts);
+			void _flatten(const Fragment &fragment);
 
+			std::shared_ptr<RenderCommandArena::Pool> _fragmentPool;
+			JobSystem *_jobSystem = nullptr;
+			std::size_t _parallelGranularity = DefaultParallelGranularity;
+			std::vector<std::shared_ptr<const Fragment>> _fragments;
+			std::unique_ptr<RenderCommandArena> _arena;
 			std::vector<PendingPass> _passes;
 		};
 
 		RenderSnapshot() = default;
+		RenderSnapshot(const RenderSnapshot &) = delete;
+		RenderSnapshot(RenderSnapshot &&) noexcept = default;
+		~RenderSnapshot() = default;
+
+		RenderSnapshot &operator=(const RenderSnapshot &) = delete;
+		RenderSnapshot &operator=(RenderSnapshot &&other) noexcept;
+
+		[[nodiscard]] std::uint64_t revision() const noexcept;
+		[[nodiscard]] std::size_t elidedCommandCount() const noexcept;
+		[[nodiscard]] const Timestamps &timestamps() const noexcept;
+		void setTimestamps(const Timestamps &timestamps) noexcept;
 		void execute(RenderContext &renderContext) const;
 
 	private:
-		explicit RenderSnapshot(
-			std::vector<std::unique_ptr<const RenderPass>> passes);
-
+		std::uint64_t _revision = 0;
+		std::size_t _elidedCommandCount = 0;
+		Timestamps _timestamps;
+		std::vector<std::shared_ptr<const Fragment>> _fragments;
+		std::unique_ptr<RenderCommandArena> _arena;
 		std::vector<std::unique_ptr<const RenderPass>> _renderPasses;
 	};
 }
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace spk
+{
+	template <typename THandle, typename TValue>
+	class SlotMap final
+	{
+		/**
+		 * Associative container keyed by generational handles such as WindowHandle. Values are stored contiguously
+		 * and iterated in that dense order; a sparse table indexed by handle.index maps each handle to its dense
+		 * position, and the full handle stored next to the value rejects stale generations. Insertion, lookup and
+		 * erasure are O(1); erasure moves the last value into the freed position, so iteration order is not stable.
+		 */
+	public:
+		struct Entry
+		{
+			THandle handle;
+			TValue value;
+		};
+
+		using iterator = typename std::vector<Entry>::iterator;
+		using const_iterator = typename std::vector<Entry>::const_iterator;
+
+	private:
+		static constexpr std::size_t InvalidPosition = static_cast<std::size_t>(-1);
+
+		std::vector<Entry> _entries;
+		std::vector<std::size_t> _positions;
+
+		[[nodiscard]] std::size_t _position(const THandle &handle) const noexcept
+		{
+			if (handle.index >= _positions.size())
+			{
+				return InvalidPosition;
+			}
+			const std::size_t position = _positions[handle.index];
+			return position != InvalidPosition && _entries[position].handle == handle ? position : InvalidPosition;
+		}
+
+	public:
+		template <typename... TArguments>
+		TValue &emplace(const THandle &handle, TArguments &&...arguments)
+		{
+			if (handle.index >= _positions.size())
+			{
+				_positions.resize(static_cast<std::size_t>(handle.index) + 1, InvalidPosition);
+			}
+			if (_positions[handle.index] != InvalidPosition)
+			{
+				throw std::logic_error("A SlotMap slot is already occupied");
+			}
+
+			_entries.push_back(Entry{handle, TValue(std::forward<TArguments>(arguments)...)});
+			_positions[handle.index] = _entries.size() - 1;
+			return _entries.back().value;
+		}
+
+		bool erase(const THandle &handle)
+		{
+			const std::size_t position = _position(handle);
+			if (position == InvalidPosition)
+			{
+				return false;
+			}
+
+			if (position != _entries.size() - 1)
+			{
+				_entries[position] = std::move(_entries.back());
+				_positions[_entries[position].handle.index] = position;
+			}
+			_entries.pop_back();
+			_positions[handle.index] = InvalidPosition;
+			return true;
+		}
+
+		void clear() noexcept
+		{
+			_entries.clear();
+			_positions.clear();
+		}
+
+		[[nodiscard]] bool contains(const THandle &handle) const noexcept
+		{
+			return _position(handle) != InvalidPosition;
+		}
+
+		[[nodiscard]] TValue *tryGet(const THandle &handle) noexcept
+		{
+			const std::size_t position = _position(handle);
+			return position != InvalidPosition ? &_entries[position].value : nullptr;
+		}
+
+		[[nodiscard]] const TValue *tryGet(const THandle &handle) const noexcept
+		{
+			const std::size_t position = _position(handle);
+			return position != InvalidPosition ? &_entries[position].value : nullptr;
+		}
+
+		[[nodiscard]] TValue &at(const THandle &handle)
+		{
+			TValue *value = tryGet(handle);
+			if (value == nullptr)
+			{
+				throw std::out_of_range("No SlotMap value is stored for this handle");
+			}
+			return *value;
+		}
+
+		[[nodiscard]] const TValue &at(const THandle &handle) const
+		{
+			const TValue *value = tryGet(handle);
+			if (value == nullptr)
+			{
+				throw std::out_of_range("No SlotMap value is stored for this handle");
+			}
+			return *value;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept
+		{
+			return _entries.size();
+		}
+
+		[[nodiscard]] bool empty() const noexcept
+		{
+			return _entries.empty();
+		}
+
+		[[nodiscard]] iterator begin() noexcept
+		{
+			return _entries.begin();
+		}
+
+		[[nodiscard]] iterator end() noexcept
+		{
+			return _entries.end();
+		}
+
+		[[nodiscard]] const_iterator begin() const noexcept
+		{
+			return _entries.begin();
+		}
+
+		[[nodiscard]] const_iterator end() const noexcept
+		{
+			return _entries.end();
+		}
+	};
+}
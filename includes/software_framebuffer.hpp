@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "color.hpp"
+#include "vector2.hpp"
+
+namespace spk
+{
+	struct SoftwareFramebuffer
+	{
+		/**
+		 * Tightly packed RGBA8 image, rows stored top to bottom. Each pixel holds its channels in memory order R, G, B, A.
+		 */
+		using Pixel = std::uint32_t;
+
+		spk::Vector2UInt size;
+		std::vector<Pixel> pixels;
+
+		void resize(const spk::Vector2UInt &newSize);
+
+		[[nodiscard]] Pixel *row(std::uint32_t y) noexcept;
+		[[nodiscard]] const Pixel *row(std::uint32_t y) const noexcept;
+		[[nodiscard]] Pixel pixel(std::uint32_t x, std::uint32_t y) const;
+
+		[[nodiscard]] static Pixel pack(const spk::Color &color) noexcept;
+		[[nodiscard]] static spk::Color unpack(Pixel pixel) noexcept;
+	};
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "job_system.hpp"
+#include "render_backend.hpp"
+#include "software_framebuffer.hpp"
+#include "thread_safe_slot.hpp"
+
+namespace spk
+{
+	class SoftwareRenderBackend final : public RenderBackend
+	{
+		/**
+		 * Plays a frame back into an in-memory RGBA8 framebuffer. Operations are recorded while the snapshot executes
+		 * and rasterised on endFrame, the framebuffer being split into square tiles processed in parallel.
+		 * Only the colour buffer exists: depth and stencil clears are ignored.
+		 */
+	public:
+		struct Configuration
+		{
+			/** Rasterises the tiles as jobs; left null, the thread ending the frame rasterises them alone. */
+			spk::JobSystem *jobSystem = nullptr;
+			std::uint32_t tileSize = 64;
+		};
+
+	private:
+		static constexpr std::size_t RecycledFrameCount = 2;
+
+		struct FillOperation
+		{
+			spk::Rect2D area;
+			SoftwareFramebuffer::Pixel value;
+		};
+
+		/** Presented frames released by every reader, kept for the next present to fill instead of allocating. */
+		struct FrameRecycler
+		{
+			std::mutex mutex;
+			std::vector<std::unique_ptr<SoftwareFramebuffer>> frames;
+		};
+
+		Configuration _configuration;
+		std::shared_ptr<FrameRecycler> _frameRecycler;
+		SoftwareFramebuffer _framebuffer;
+		spk::Rect2D _viewport;
+		std::optional<spk::Rect2D> _scissor;
+		std::vector<FillOperation> _operations;
+		spk::ThreadSafeSlot<SoftwareFramebuffer> _presentedFrame;
+
+		[[nodiscard]] std::unique_ptr<SoftwareFramebuffer> _acquireFrame();
+		[[nodiscard]] spk::Rect2D _frameArea() const noexcept;
+		void _rasterizeTile(const spk::Rect2D &tile);
+		void _rasterize();
+		void _present();
+
+	public:
+		SoftwareRenderBackend();
+		explicit SoftwareRenderBackend(const Configuration &configuration);
+
+		void execute(const RenderPass &pass, RenderContext &renderContext) override;
+		void beginFrame(const spk::Vector2UInt &size) override;
+		void setViewport(const spk::Rect2D &viewport) override;
+		void setScissor(const spk::Rect2D &scissor) override;
+		void clear(const spk::Color &color, ClearRenderCommand::Mask mask) override;
+		void endFrame() override;
+
+		[[nodiscard]] const Configuration &configuration() const noexcept;
+		[[nodiscard]] const spk::Rect2D &viewport() const noexcept;
+		[[nodiscard]] const SoftwareFramebuffer &framebuffer() const noexcept;
+		[[nodiscard]] std::shared_ptr<const SoftwareFramebuffer> presentedFrame() const noexcept;
+	};
+}
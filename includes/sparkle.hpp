@@ -9,35 +9,48 @@
 #include "color.hpp"
 #include "contract_provider.hpp"
 #include "event.hpp"
+#include "event_record_stream.hpp"
 #include "focus_mode.hpp"
-#include "frame.hpp"
+#include "frame_pacer.hpp"
 #include "gpu_resource.hpp"
 #include "gpu_resource_collection.hpp"
 #include "index_buffer.hpp"
 #include "inherence_trait.hpp"
 #include "input_state.hpp"
 #include "keyboard.hpp"
+#include "job_system.hpp"
+#include "latency_histogram.hpp"
 #include "layout_buffer.hpp"
-#include "message_queue.hpp"
 #include "mouse.hpp"
+#include "mpsc_fifo.hpp"
 #include "name_trait.hpp"
+#include "opengl_render_backend.hpp"
 #include "padding.hpp"
+#include "platform.hpp"
 #include "platform_request.hpp"
+#include "profiler.hpp"
 #include "program.hpp"
 #include "protected_data.hpp"
 #include "record.hpp"
 #include "rect2d.hpp"
+#include "render_backend.hpp"
 #include "render_command.hpp"
+#include "render_command_arena.hpp"
 #include "render_context.hpp"
 #include "render_pass.hpp"
 #include "render_request.hpp"
 #include "render_snapshot.hpp"
 #include "resizeable_trait.hpp"
 #include "scissor_render_command.hpp"
+#include "software_framebuffer.hpp"
+#include "software_render_backend.hpp"
+#include "spsc_fifo.hpp"
 #include "statefull_trait.hpp"
+#include "task.hpp"
 #include "thread_safe_collection.hpp"
 #include "thread_safe_fifo.hpp"
 #include "thread_safe_slot.hpp"
+#include "triple_buffer.hpp"
 #include "uniform_buffer.hpp"
 #include "update_context.hpp"
 #include "update_request.hpp"
@@ -47,6 +60,17 @@
 #include "vertex_buffer.hpp"
 #include "viewport_render_command.hpp"
 #include "view_region.hpp"
-#include "wake_event.hpp"
+#include "wake_signal.hpp"
 #include "widget.hpp"
+#include "widget_spatial_index.hpp"
 #include "window.hpp"
+#include "window_handle.hpp"
+
+#if defined(SPARKLE_PLATFORM_WINAPI)
+#include "frame.hpp"
+#include "message_queue.hpp"
+#include "wake_event.hpp"
+#elif defined(SPARKLE_PLATFORM_HEADLESS)
+#include "headless_frame.hpp"
+#include "headless_wake_event.hpp"
+#endif
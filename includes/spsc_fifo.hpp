@@ -0,0 +1,579 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+#include <vector>
+
+namespace spk
+{
+	template <typename TValue, std::size_t TSegmentCapacity = 256>
+	class SPSCFIFO final
+	{
+		/**
+		 * Single-producer, single-consumer counterpart of ThreadSafeFIFO. Values are stored in a linked chain of
+		 * fixed-size segments: publish and drain only touch atomics and never block, and the producer grows the chain
+		 * when the consumer lags behind. The last consumed segment is kept aside for the producer to reuse, so a
+		 * steady stream does not allocate. A mutex is only taken when the consumer blocks in wait.
+		 *
+		 * Unbounded by default. With a capacity, a producer publishing into a full queue either discards the value or
+		 * waits for the consumer to drain; under the Coalesce policy a value with a coalescing key is instead held
+		 * back as the newest value, and replaced by later values sharing its key until the consumer takes it. Held
+		 * values always stay behind everything published before them, so coalescing never reorders the stream. The
+		 * overflow path takes the mutex; publishing below capacity stays lock-free. Closing the queue releases a
+		 * blocked producer, dropping the values that would have waited.
+		 */
+	public:
+		using value_type = TValue;
+		using container_type = std::vector<value_type>;
+
+		static_assert(TSegmentCapacity > 0, "An SPSCFIFO segment requires a positive capacity");
+
+		static constexpr std::size_t Unbounded = std::numeric_limits<std::size_t>::max();
+
+		enum class OverflowPolicy
+		{
+			Block,
+			DropNewest,
+			Coalesce
+		};
+
+		struct Configuration
+		{
+			std::size_t capacity = Unbounded;
+			OverflowPolicy overflowPolicy = OverflowPolicy::Block;
+			std::function<std::optional<std::size_t>(const value_type &)> coalescingKey;
+		};
+
+		struct Statistics
+		{
+			std::uint64_t blockedCount = 0;
+			std::uint64_t droppedCount = 0;
+			std::uint64_t coalescedCount = 0;
+			std::size_t highWaterMark = 0;
+		};
+
+	private:
+		struct Segment
+		{
+			alignas(value_type) std::array<std::byte, sizeof(value_type) * TSegmentCapacity> storage;
+			std::atomic<std::size_t> writtenCount = 0;
+			std::size_t readCount = 0;
+			std::atomic<Segment *> next = nullptr;
+
+			[[nodiscard]] value_type *slot(std::size_t index) noexcept
+			{
+				return std::launder(reinterpret_cast<value_type *>(storage.data() + index * sizeof(value_type)));
+			}
+		};
+
+		struct State
+		{
+			static constexpr std::size_t CacheLineSize = 64;
+
+			const Configuration configuration;
+			alignas(CacheLineSize) Segment *tail;
+			std::size_t publishedCount = 0;
+			alignas(CacheLineSize) Segment *head;
+			std::atomic<std::size_t> consumedCount = 0;
+			alignas(CacheLineSize) std::atomic<Segment *> spare = nullptr;
+			std::atomic<bool> isConsumerWaiting = false;
+			std::atomic<bool> isProducerWaiting = false;
+			std::atomic<bool> isHoldingValue = false;
+			std::mutex mutex;
+			std::condition_variable_any condition;
+			std::condition_variable_any spaceCondition;
+			std::optional<value_type> heldValue;
+			bool isClosed = false;
+			std::atomic<std::uint64_t> blockedCount = 0;
+			std::atomic<std::uint64_t> droppedCount = 0;
+			std::atomic<std::uint64_t> coalescedCount = 0;
+			std::atomic<std::size_t> highWaterMark = 0;
+
+			explicit State(Configuration p_configuration) :
+				configuration(std::move(p_configuration)),
+				tail(new Segment()),
+				head(tail)
+			{
+				if (configuration.capacity == 0)
+				{
+					delete tail;
+					throw std::invalid_argument("An SPSCFIFO requires a positive capacity");
+				}
+				if (configuration.overflowPolicy == OverflowPolicy::Coalesce && !configuration.coalescingKey)
+				{
+					delete tail;
+					throw std::invalid_argument("A coalescing SPSCFIFO requires a coalescing key");
+				}
+			}
+
+			State(const State &) = delete;
+			State &operator=(const State &) = delete;
+
+			~State()
+			{
+				Segment *segment = head;
+				while (segment != nullptr)
+				{
+					const std::size_t writtenCount = segment->writtenCount.load(std::memory_order_acquire);
+					for (std::size_t index = segment->readCount; index < writtenCount; ++index)
+					{
+						std::destroy_at(segment->slot(index));
+					}
+					delete std::exchange(segment, segment->next.load(std::memory_order_acquire));
+				}
+				delete spare.load(std::memory_order_acquire);
+			}
+
+			[[nodiscard]] Segment *acquireSegment()
+			{
+				Segment *result = spare.exchange(nullptr, std::memory_order_acquire);
+				return result != nullptr ? result : new Segment();
+			}
+
+			void recycleSegment(Segment *segment) noexcept
+			{
+				segment->writtenCount.store(0, std::memory_order_relaxed);
+				segment->readCount = 0;
+				segment->next.store(nullptr, std::memory_order_relaxed);
+				delete spare.exchange(segment, std::memory_order_acq_rel);
+			}
+
+			[[nodiscard]] bool isBounded() const noexcept
+			{
+				return configuration.capacity != Unbounded;
+			}
+
+			/** Number of published values the consumer has not drained yet; only meaningful on the producer side. */
+			[[nodiscard]] std::size_t size() const noexcept
+			{
+				return publishedCount - consumedCount.load(std::memory_order_seq_cst);
+			}
+
+			void signalConsumer()
+			{
+				if (isConsumerWaiting.load(std::memory_order_seq_cst))
+				{
+					{
+						const std::scoped_lock lock(mutex);
+					}
+					condition.notify_one();
+				}
+			}
+
+			template <typename... TArguments>
+			void write(TArguments &&...arguments)
+			{
+				std::size_t index = tail->writtenCount.load(std::memory_order_relaxed);
+				if (index == TSegmentCapacity)
+				{
+					Segment *segment = acquireSegment();
+					tail->next.store(segment, std::memory_order_seq_cst);
+					tail = segment;
+					index = 0;
+				}
+
+				std::construct_at(tail->slot(index), std::forward<TArguments>(arguments)...);
+				tail->writtenCount.store(index + 1, std::memory_order_seq_cst);
+			}
+
+			void recordPublication(std::size_t count) noexcept
+			{
+				publishedCount += count;
+				highWaterMark.store(std::max(highWaterMark.load(std::memory_order_relaxed), size()), std::memory_order_relaxed);
+			}
+
+			[[nodiscard]] bool isCoalescible(const value_type &held, const value_type &value) const
+			{
+				const std::optional<std::size_t> key = configuration.coalescingKey(value);
+				return key.has_value() && configuration.coalescingKey(held) == key;
+			}
+
+			void publishOverflowing(value_type &&value)
+			{
+				std::unique_lock lock(mutex);
+				while (true)
+				{
+					if (heldValue.has_value())
+					{
+						if (isCoalescible(*heldValue, value))
+						{
+							*heldValue = std::move(value);
+							coalescedCount.fetch_add(1, std::memory_order_relaxed);
+							return;
+						}
+						if (size() < configuration.capacity)
+						{
+							// The held value is older than the incoming one, so it must be published first.
+							write(std::move(*heldValue));
+							recordPublication(1);
+							heldValue.reset();
+							isHoldingValue.store(false, std::memory_order_seq_cst);
+							continue;
+						}
+					}
+					else if (size() < configuration.capacity)
+					{
+						write(std::move(value));
+						recordPublication(1);
+						break;
+					}
+					else if (configuration.overflowPolicy == OverflowPolicy::DropNewest)
+					{
+						droppedCount.fetch_add(1, std::memory_order_relaxed);
+						return;
+					}
+					else if (configuration.overflowPolicy == OverflowPolicy::Coalesce && configuration.coalescingKey(value).has_value())
+					{
+						heldValue.emplace(std::move(value));
+						isHoldingValue.store(true, std::memory_order_seq_cst);
+						break;
+					}
+
+					if (isClosed)
+					{
+						droppedCount.fetch_add(1, std::memory_order_relaxed);
+						return;
+					}
+					blockedCount.fetch_add(1, std::memory_order_relaxed);
+					isProducerWaiting.store(true, std::memory_order_seq_cst);
+					spaceCondition.wait(
+						lock,
+						[this] {
+							return size() < configuration.capacity || isClosed;
+						});
+					isProducerWaiting.store(false, std::memory_order_relaxed);
+				}
+
+				// The mutex is already held, so a waiting consumer can be notified directly.
+				if (isConsumerWaiting.load(std::memory_order_seq_cst))
+				{
+					condition.notify_one();
+				}
+			}
+
+			void publish(value_type &&value)
+			{
+				if (isHoldingValue.load(std::memory_order_acquire) || size() >= configuration.capacity)
+				{
+					publishOverflowing(std::move(value));
+					return;
+				}
+				write(std::move(value));
+				recordPublication(1);
+				signalConsumer();
+			}
+
+			template <typename... TArguments>
+			void emplace(TArguments &&...arguments)
+			{
+				if (isBounded())
+				{
+					publish(value_type(std::forward<TArguments>(arguments)...));
+					return;
+				}
+				write(std::forward<TArguments>(arguments)...);
+				signalConsumer();
+			}
+
+			void publishBatch(std::span<value_type> values)
+			{
+				if (values.empty())
+				{
+					return;
+				}
+				if (isBounded())
+				{
+					if (isHoldingValue.load(std::memory_order_acquire) || size() + values.size() > configuration.capacity)
+					{
+						for (value_type &value : values)
+						{
+							publish(std::move(value));
+						}
+						return;
+					}
+					recordPublication(values.size());
+				}
+
+				// The consumer cannot move past the first segment written to before its count is published, so the
+				// later segments of the chain are filled quietly and the whole batch appears with that last store.
+				Segment *first = nullptr;
+				std::size_t firstCount = 0;
+				std::size_t index = tail->writtenCount.load(std::memory_order_relaxed);
+				for (value_type &value : values)
+				{
+					if (index == TSegmentCapacity)
+					{
+						if (first != nullptr && tail != first)
+						{
+							tail->writtenCount.store(index, std::memory_order_relaxed);
+						}
+						Segment *segment = acquireSegment();
+						tail->next.store(segment, std::memory_order_release);
+						tail = segment;
+						index = 0;
+					}
+					if (first == nullptr)
+					{
+						first = tail;
+					}
+					std::construct_at(tail->slot(index++), std::move(value));
+					if (tail == first)
+					{
+						firstCount = index;
+					}
+				}
+				if (tail != first)
+				{
+					tail->writtenCount.store(index, std::memory_order_relaxed);
+				}
+				first->writtenCount.store(firstCount, std::memory_order_seq_cst);
+
+				if (isConsumerWaiting.load(std::memory_order_seq_cst))
+				{
+					{
+						const std::scoped_lock lock(mutex);
+					}
+					condition.notify_one();
+				}
+			}
+
+			[[nodiscard]] bool isEmpty() const noexcept
+			{
+				Segment *segment = head;
+				if (segment->readCount != segment->writtenCount.load(std::memory_order_seq_cst))
+				{
+					return false;
+				}
+				if (segment->readCount == TSegmentCapacity && segment->next.load(std::memory_order_seq_cst) != nullptr)
+				{
+					return false;
+				}
+				return !isHoldingValue.load(std::memory_order_seq_cst);
+			}
+
+			[[nodiscard]] bool wait(std::stop_token stopToken)
+			{
+				if (!isEmpty())
+				{
+					return true;
+				}
+
+				std::unique_lock lock(mutex);
+				isConsumerWaiting.store(true, std::memory_order_seq_cst);
+				const bool result = condition.wait(
+					lock,
+					stopToken,
+					[this] {
+						return !isEmpty();
+					});
+				isConsumerWaiting.store(false, std::memory_order_relaxed);
+				return result;
+			}
+
+			void drainSegments(container_type &toFill)
+			{
+				const std::size_t initialSize = toFill.size();
+				while (true)
+				{
+					Segment *segment = head;
+					const std::size_t writtenCount = segment->writtenCount.load(std::memory_order_acquire);
+					for (; segment->readCount < writtenCount; ++segment->readCount)
+					{
+						value_type *value = segment->slot(segment->readCount);
+						toFill.push_back(std::move(*value));
+						std::destroy_at(value);
+					}
+
+					if (segment->readCount != TSegmentCapacity)
+					{
+						break;
+					}
+
+					Segment *next = segment->next.load(std::memory_order_acquire);
+					if (next == nullptr)
+					{
+						break;
+					}
+					head = next;
+					recycleSegment(segment);
+				}
+				consumedCount.fetch_add(toFill.size() - initialSize, std::memory_order_seq_cst);
+			}
+
+			[[nodiscard]] container_type &drain(container_type &toFill)
+			{
+				toFill.clear();
+				drainSegments(toFill);
+
+				if (isHoldingValue.load(std::memory_order_seq_cst))
+				{
+					const std::scoped_lock lock(mutex);
+					// Everything published before the held value is already in the segments.
+					drainSegments(toFill);
+					if (heldValue.has_value())
+					{
+						toFill.push_back(std::move(*heldValue));
+						heldValue.reset();
+						isHoldingValue.store(false, std::memory_order_seq_cst);
+					}
+					if (isProducerWaiting.load(std::memory_order_seq_cst))
+					{
+						spaceCondition.notify_all();
+					}
+				}
+				else if (isProducerWaiting.load(std::memory_order_seq_cst))
+				{
+					{
+						const std::scoped_lock lock(mutex);
+					}
+					spaceCondition.notify_all();
+				}
+				return toFill;
+			}
+
+			void close()
+			{
+				{
+					const std::scoped_lock lock(mutex);
+					isClosed = true;
+				}
+				spaceCondition.notify_all();
+			}
+
+			[[nodiscard]] Statistics statistics() const noexcept
+			{
+				return {
+					.blockedCount = blockedCount.load(std::memory_order_relaxed),
+					.droppedCount = droppedCount.load(std::memory_order_relaxed),
+					.coalescedCount = coalescedCount.load(std::memory_order_relaxed),
+					.highWaterMark = highWaterMark.load(std::memory_order_relaxed)};
+			}
+		};
+
+		std::shared_ptr<State> _state;
+
+	public:
+		class Producer
+		{
+		private:
+			std::shared_ptr<State> _state;
+
+			explicit Producer(std::shared_ptr<State> state) :
+				_state(std::move(state))
+			{
+			}
+
+			friend class SPSCFIFO;
+
+		public:
+			Producer(const Producer &) = delete;
+			Producer(Producer &&) = default;
+
+			Producer &operator=(const Producer &) = delete;
+			Producer &operator=(Producer &&) = default;
+
+			void publish(value_type value)
+			{
+				_state->emplace(std::move(value));
+			}
+
+			template <typename... TArguments>
+			void emplace(TArguments &&...arguments)
+			{
+				_state->emplace(std::forward<TArguments>(arguments)...);
+			}
+
+			/** Moves every value out of values and makes them visible to the consumer at once. */
+			void publishBatch(std::span<value_type> values)
+			{
+				_state->publishBatch(values);
+			}
+
+			void close()
+			{
+				_state->close();
+			}
+
+			[[nodiscard]] Statistics statistics() const noexcept
+			{
+				return _state->statistics();
+			}
+		};
+
+		class Consumer
+		{
+		private:
+			std::shared_ptr<State> _state;
+			container_type _values;
+
+			explicit Consumer(std::shared_ptr<State> state) :
+				_state(std::move(state))
+			{
+			}
+
+			friend class SPSCFIFO;
+
+		public:
+			Consumer(const Consumer &) = delete;
+			Consumer(Consumer &&) = default;
+
+			Consumer &operator=(const Consumer &) = delete;
+			Consumer &operator=(Consumer &&) = default;
+
+			[[nodiscard]] bool wait(std::stop_token stopToken = {})
+			{
+				return _state->wait(stopToken);
+			}
+
+			[[nodiscard]] container_type &drain()
+			{
+				return _state->drain(_values);
+			}
+
+			/** Releases a producer blocked on a full queue; values it could not publish are dropped. */
+			void close()
+			{
+				_state->close();
+			}
+
+			[[nodiscard]] Statistics statistics() const noexcept
+			{
+				return _state->statistics();
+			}
+		};
+
+		struct Endpoints
+		{
+			Producer producer;
+			Consumer consumer;
+		};
+
+		[[nodiscard]] static Endpoints create()
+		{
+			return create(Configuration{});
+		}
+
+		[[nodiscard]] static Endpoints create(Configuration configuration)
+		{
+			auto state = std::make_shared<State>(std::move(configuration));
+
+			return {
+				.producer = Producer(state),
+				.consumer = Consumer(std::move(state))};
+		}
+	};
+}
@@ -0,0 +1,375 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "job_system.hpp"
+#include "wake_signal.hpp"
+
+namespace spk
+{
+	class TaskScheduler;
+
+	class Task final
+	{
+		/**
+		 * Coroutine type for widget logic spread over several updates. A Task does nothing until it is handed to
+		 * TaskScheduler::start, and every resumption then happens on the update thread, before the windows are
+		 * ticked. The Task owns its coroutine frame: destroying it cancels the coroutine wherever it is suspended, which
+		 * must happen on the update thread or while the application is not running.
+		 */
+	public:
+		struct State
+		{
+			std::coroutine_handle<> handle = nullptr;
+			TaskScheduler *scheduler = nullptr;
+		};
+
+		struct promise_type
+		{
+			std::shared_ptr<State> state = std::make_shared<State>();
+			std::exception_ptr exception = nullptr;
+
+			Task get_return_object() noexcept
+			{
+				const auto handle = std::coroutine_handle<promise_type>::from_promise(*this);
+				state->handle = handle;
+				return Task(handle);
+			}
+
+			std::suspend_always initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			std::suspend_always final_suspend() noexcept
+			{
+				return {};
+			}
+
+			void return_void() noexcept
+			{
+			}
+
+			void unhandled_exception() noexcept
+			{
+				exception = std::current_exception();
+			}
+		};
+
+	private:
+		std::coroutine_handle<promise_type> _handle = nullptr;
+
+		explicit Task(std::coroutine_handle<promise_type> handle) noexcept :
+			_handle(handle)
+		{
+		}
+
+		void _destroy() noexcept
+		{
+			if (_handle == nullptr)
+			{
+				return;
+			}
+			_handle.promise().state->handle = nullptr;
+			_handle.destroy();
+			_handle = nullptr;
+		}
+
+		friend class TaskScheduler;
+
+	public:
+		Task() = default;
+		Task(const Task &) = delete;
+
+		Task(Task &&other) noexcept :
+			_handle(std::exchange(other._handle, nullptr))
+		{
+		}
+
+		~Task()
+		{
+			_destroy();
+		}
+
+		Task &operator=(const Task &) = delete;
+
+		Task &operator=(Task &&other) noexcept
+		{
+			if (this != &other)
+			{
+				_destroy();
+				_handle = std::exchange(other._handle, nullptr);
+			}
+			return *this;
+		}
+
+		[[nodiscard]] bool isValid() const noexcept
+		{
+			return _handle != nullptr;
+		}
+
+		[[nodiscard]] bool isDone() const noexcept
+		{
+			return _handle != nullptr && _handle.done();
+		}
+
+		/** Rethrows the exception that ended the coroutine, if any. */
+		void rethrowIfFailed() const
+		{
+			if (isDone() && _handle.promise().exception != nullptr)
+			{
+				std::rethrow_exception(_handle.promise().exception);
+			}
+		}
+	};
+
+	class TaskScheduler final
+	{
+		/**
+		 * Resumes suspended Tasks from the update thread. Suspensions and job completions may come from any thread and
+		 * only enqueue the coroutine; resumeReady runs them in a batch. A coroutine suspended on a timer costs a heap
+		 * entry, one waiting on a job costs nothing until the job completes, and only message waits are polled, once
+		 * per cycle and at least once per polling period.
+		 */
+	public:
+		using Clock = std::chrono::steady_clock;
+		using Predicate = std::function<bool()>;
+
+	private:
+		struct TimedEntry
+		{
+			Clock::time_point deadline;
+			std::shared_ptr<Task::State> state;
+
+			[[nodiscard]] bool operator<(const TimedEntry &other) const noexcept
+			{
+				return deadline > other.deadline;
+			}
+		};
+
+		struct PolledEntry
+		{
+			Predicate predicate;
+			std::shared_ptr<Task::State> state;
+		};
+
+		spk::WakeSignal &_wakeSignal;
+		Clock::duration _pollingPeriod;
+		mutable std::mutex _mutex;
+		std::vector<std::shared_ptr<Task::State>> _ready;
+		std::vector<TimedEntry> _timers;
+		std::vector<PolledEntry> _polled;
+		std::vector<std::shared_ptr<Task::State>> _resuming;
+		std::vector<PolledEntry> _polling;
+
+	public:
+		TaskScheduler(spk::WakeSignal &wakeSignal, Clock::duration pollingPeriod);
+		TaskScheduler(const TaskScheduler &) = delete;
+		TaskScheduler(TaskScheduler &&) = delete;
+
+		TaskScheduler &operator=(const TaskScheduler &) = delete;
+		TaskScheduler &operator=(TaskScheduler &&) = delete;
+
+		/** Schedules the first resumption of task for the next cycle; the caller keeps owning it. */
+		void start(Task &task);
+
+		/** Callable from any thread: resumes state at the next cycle and wakes the update thread. */
+		void schedule(std::shared_ptr<Task::State> state);
+		/**
+		 * Callable from any thread, including jobs of a parallel window update, but without waking the update thread:
+		 * resumes state at the next cycle, whenever the pacing or other activity triggers it. Meant for calls made
+		 * during a cycle, whose end reads the pending work to plan the next one.
+		 */
+		void defer(std::shared_ptr<Task::State> state);
+		/** Callable from any thread like defer; the predicate of scheduleWhen is evaluated once per cycle until true. */
+		void scheduleAt(Clock::time_point deadline, std::shared_ptr<Task::State> state);
+		void scheduleWhen(Predicate predicate, std::shared_ptr<Task::State> state);
+
+		void resumeReady(Clock::time_point now);
+		[[nodiscard]] std::optional<Clock::time_point> nextDeadline(Clock::time_point now) const;
+	};
+
+	class TaskAwaiter
+	{
+	protected:
+		std::shared_ptr<Task::State> _state;
+
+		[[nodiscard]] TaskScheduler &_capture(std::coroutine_handle<Task::promise_type> handle) noexcept
+		{
+			_state = handle.promise().state;
+			return *_state->scheduler;
+		}
+
+	public:
+		[[nodiscard]] bool await_ready() const noexcept
+		{
+			return false;
+		}
+	};
+
+	/** Suspends until the next update cycle. */
+	class NextUpdateAwaiter final : public TaskAwaiter
+	{
+	public:
+		void await_suspend(std::coroutine_handle<Task::promise_type> handle)
+		{
+			_capture(handle).defer(_state);
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+	};
+
+	class DelayAwaiter final : public TaskAwaiter
+	{
+	private:
+		TaskScheduler::Clock::duration _duration;
+
+	public:
+		explicit DelayAwaiter(TaskScheduler::Clock::duration duration) noexcept :
+			_duration(duration)
+		{
+		}
+
+		void await_suspend(std::coroutine_handle<Task::promise_type> handle)
+		{
+			_capture(handle).scheduleAt(TaskScheduler::Clock::now() + _duration, _state);
+		}
+
+		void await_resume() const noexcept
+		{
+		}
+	};
+
+	class JobAwaiter final : public TaskAwaiter
+	{
+		/**
+		 * Runs a job on the JobSystem and resumes the coroutine once it returned, rethrowing what it threw. Without
+		 * running workers nothing would ever pick the job up, so it is then run inline without suspending.
+		 */
+	private:
+		spk::JobSystem &_jobSystem;
+		spk::JobSystem::Job _job;
+		spk::JobSystem::TaskGroup _group;
+		std::exception_ptr _exception = nullptr;
+
+	public:
+		JobAwaiter(spk::JobSystem &jobSystem, spk::JobSystem::Job job) :
+			_jobSystem(jobSystem),
+			_job(std::move(job)),
+			_group(jobSystem)
+		{
+		}
+
+		[[nodiscard]] bool await_ready()
+		{
+			if (_jobSystem.isRunning() && _jobSystem.workerCount() != 0)
+			{
+				return false;
+			}
+			try
+			{
+				_job();
+			}
+			catch (...)
+			{
+				_exception = std::current_exception();
+			}
+			return true;
+		}
+
+		void await_suspend(std::coroutine_handle<Task::promise_type> handle)
+		{
+			TaskScheduler &scheduler = _capture(handle);
+			_group.run(
+				[this, &scheduler, state = _state] {
+					try
+					{
+						_job();
+					}
+					catch (...)
+					{
+						_exception = std::current_exception();
+					}
+					scheduler.schedule(state);
+				});
+		}
+
+		void await_resume()
+		{
+			if (_exception != nullptr)
+			{
+				std::rethrow_exception(_exception);
+			}
+		}
+	};
+
+	template <typename TConsumer>
+	class MessageAwaiter final : public TaskAwaiter
+	{
+		/** Drains a FIFO consumer owned by the coroutine's side; resumes with the non-empty batch it drained. */
+	private:
+		using container_type = std::remove_reference_t<decltype(std::declval<TConsumer &>().drain())>;
+
+		TConsumer &_consumer;
+		container_type *_messages = nullptr;
+
+		[[nodiscard]] bool _poll()
+		{
+			_messages = &_consumer.drain();
+			return !_messages->empty();
+		}
+
+	public:
+		explicit MessageAwaiter(TConsumer &consumer) noexcept :
+			_consumer(consumer)
+		{
+		}
+
+		[[nodiscard]] bool await_ready()
+		{
+			return _poll();
+		}
+
+		void await_suspend(std::coroutine_handle<Task::promise_type> handle)
+		{
+			_capture(handle).scheduleWhen([this] { return _poll(); }, _state);
+		}
+
+		[[nodiscard]] container_type &await_resume() noexcept
+		{
+			return *_messages;
+		}
+	};
+
+	[[nodiscard]] inline NextUpdateAwaiter nextUpdate() noexcept
+	{
+		return {};
+	}
+
+	[[nodiscard]] inline DelayAwaiter delay(TaskScheduler::Clock::duration duration) noexcept
+	{
+		return DelayAwaiter(duration);
+	}
+
+	[[nodiscard]] inline JobAwaiter runJob(spk::JobSystem &jobSystem, spk::JobSystem::Job job)
+	{
+		return JobAwaiter(jobSystem, std::move(job));
+	}
+
+	template <typename TConsumer>
+	[[nodiscard]] MessageAwaiter<TConsumer> nextMessages(TConsumer &consumer) noexcept
+	{
+		return MessageAwaiter<TConsumer>(consumer);
+	}
+}
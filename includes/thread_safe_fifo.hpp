@@ -1,8 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <stop_token>
 #include <utility>
 #include <vector>
@@ -12,22 +21,144 @@ namespace spk
 	template <typename TValue>
 	class ThreadSafeFIFO final
 	{
+		/**
+		 * Unbounded by default. With a capacity, the overflow policy decides what a producer publishing into a full
+		 * queue does: wait for the consumer to drain, discard the oldest queued value, discard the incoming one, or
+		 * replace the newest queued value when it shares its coalescing key. Only the newest value is ever replaced,
+		 * so merging never moves a value ahead of one queued after it; values without a key, or whose key differs
+		 * from the newest value's, fall back to blocking. Closing the queue releases every blocked producer: from then
+		 * on, a value that would have waited for space is dropped instead.
+		 */
 	public:
 		using value_type = TValue;
 		using container_type = std::vector<value_type>;
 
+		static constexpr std::size_t Unbounded = std::numeric_limits<std::size_t>::max();
+
+		enum class OverflowPolicy
+		{
+			Block,
+			DropOldest,
+			DropNewest,
+			Coalesce
+		};
+
+		struct Configuration
+		{
+			std::size_t capacity = Unbounded;
+			OverflowPolicy overflowPolicy = OverflowPolicy::Block;
+			std::function<std::optional<std::size_t>(const value_type &)> coalescingKey;
+		};
+
+		struct Statistics
+		{
+			std::uint64_t blockedCount = 0;
+			std::uint64_t droppedCount = 0;
+			std::uint64_t coalescedCount = 0;
+			std::size_t highWaterMark = 0;
+		};
+
 	private:
 		struct State
 		{
+			Configuration configuration;
 			mutable std::mutex mutex;
 			std::condition_variable_any condition;
+			std::condition_variable_any spaceCondition;
 			container_type values;
+			std::size_t firstIndex = 0;
+			Statistics statistics;
+			bool isClosed = false;
+
+			explicit State(Configuration p_configuration) :
+				configuration(std::move(p_configuration))
+			{
+				if (configuration.capacity == 0)
+				{
+					throw std::invalid_argument("A ThreadSafeFIFO requires a positive capacity");
+				}
+				if (configuration.overflowPolicy == OverflowPolicy::Coalesce && !configuration.coalescingKey)
+				{
+					throw std::invalid_argument("A coalescing ThreadSafeFIFO requires a coalescing key");
+				}
+			}
+
+			[[nodiscard]] std::size_t size() const noexcept
+			{
+				return values.size() - firstIndex;
+			}
+
+			[[nodiscard]] bool coalesce(value_type &value)
+			{
+				const std::optional<std::size_t> key = configuration.coalescingKey(value);
+				if (!key.has_value() || size() == 0 || configuration.coalescingKey(values.back()) != key)
+				{
+					return false;
+				}
+
+				values.back() = std::move(value);
+				++statistics.coalescedCount;
+				return true;
+			}
+
+			void dropOldest()
+			{
+				++firstIndex;
+				++statistics.droppedCount;
+				if (firstIndex >= values.size() / 2)
+				{
+					values.erase(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(firstIndex));
+					firstIndex = 0;
+				}
+			}
+
+			void push(std::unique_lock<std::mutex> &lock, value_type &&value)
+			{
+				if (size() >= configuration.capacity)
+				{
+					switch (configuration.overflowPolicy)
+					{
+					case OverflowPolicy::DropNewest:
+						++statistics.droppedCount;
+						return;
+					case OverflowPolicy::DropOldest:
+						dropOldest();
+						break;
+					case OverflowPolicy::Coalesce:
+						if (coalesce(value))
+						{
+							return;
+						}
+						[[fallthrough]];
+					case OverflowPolicy::Block:
+						if (!isClosed)
+						{
+							++statistics.blockedCount;
+							condition.notify_one();
+							spaceCondition.wait(
+								lock,
+								[this] {
+									return size() < configuration.capacity || isClosed;
+								});
+						}
+						if (size() >= configuration.capacity)
+						{
+							++statistics.droppedCount;
+							return;
+						}
+						break;
+					}
+				}
+
+				values.push_back(std::move(value));
+				statistics.highWaterMark = std::max(statistics.highWaterMark, size());
+			}
 
 			void publish(value_type value)
 			{
 				{
-					const std::scoped_lock lock(mutex);
-					values.push_back(std::move(value));
+					std::unique_lock lock(mutex);
+					push(lock, std::move(value));
 				}
 
 				condition.notify_one();
@@ -37,10 +168,36 @@ namespace spk
 			void emplace(TArguments &&...arguments)
 			{
 				{
-					const std::scoped_lock lock(mutex);
+					std::unique_lock lock(mutex);
+
+					if (configuration.capacity == Unbounded)
+					{
+						values.emplace_back(
+							std::forward<TArguments>(arguments)...);
+						statistics.highWaterMark = std::max(statistics.highWaterMark, size());
+					}
+					else
+					{
+						push(lock, value_type(std::forward<TArguments>(arguments)...));
+					}
+				}
 
-					values.emplace_back(
-						std::forward<TArguments>(arguments)...);
+				condition.notify_one();
+			}
+
+			void publishBatch(std::span<value_type> batch)
+			{
+				if (batch.empty())
+				{
+					return;
+				}
+
+				{
+					std::unique_lock lock(mutex);
+					for (value_type &value : batch)
+					{
+						push(lock, std::move(value));
+					}
 				}
 
 				condition.notify_one();
@@ -54,19 +211,44 @@ namespace spk
 					lock,
 					stopToken,
 					[this] {
-						return !values.empty();
+						return size() != 0;
 					});
 			}
 
 			[[nodiscard]] container_type &drain(container_type &toFill)
 			{
-				const std::scoped_lock lock(mutex);
+				{
+					const std::scoped_lock lock(mutex);
+
+					values.erase(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(firstIndex));
+					firstIndex = 0;
+
+					toFill.clear();
+					toFill.swap(values);
+				}
 
-				toFill.clear();
-				toFill.swap(values);
+				if (configuration.capacity != Unbounded)
+				{
+					spaceCondition.notify_all();
+				}
 
 				return toFill;
 			}
+
+			void close()
+			{
+				{
+					const std::scoped_lock lock(mutex);
+					isClosed = true;
+				}
+				spaceCondition.notify_all();
+			}
+
+			[[nodiscard]] Statistics readStatistics() const
+			{
+				const std::scoped_lock lock(mutex);
+				return statistics;
+			}
 		};
 
 		std::shared_ptr<State> _state;
@@ -95,6 +277,21 @@ namespace spk
 			{
 				_state->emplace(std::forward<TArguments>(arguments)...);
 			}
+
+			void publishBatch(std::span<value_type> values)
+			{
+				_state->publishBatch(values);
+			}
+
+			void close()
+			{
+				_state->close();
+			}
+
+			[[nodiscard]] Statistics statistics() const
+			{
+				return _state->readStatistics();
+			}
 		};
 
 		class Consumer
@@ -126,6 +323,17 @@ namespace spk
 			{
 				return _state->drain(_values);
 			}
+
+			/** Releases producers blocked on a full queue, for a consumer that is about to stop draining. */
+			void close()
+			{
+				_state->close();
+			}
+
+			[[nodiscard]] Statistics statistics() const
+			{
+				return _state->readStatistics();
+			}
 		};
 
 		struct Endpoints
@@ -135,7 +343,12 @@ namespace spk
 		};
 
 		ThreadSafeFIFO() :
-			_state(std::make_shared<State>())
+			ThreadSafeFIFO(Configuration{})
+		{
+		}
+
+		explicit ThreadSafeFIFO(Configuration configuration) :
+			_state(std::make_shared<State>(std::move(configuration)))
 		{
 		}
 
@@ -160,9 +373,24 @@ namespace spk
 			return _state->drain(toFill);
 		}
 
+		void close()
+		{
+			_state->close();
+		}
+
+		[[nodiscard]] Statistics statistics() const
+		{
+			return _state->readStatistics();
+		}
+
 		[[nodiscard]] static Endpoints create()
 		{
-			auto state = std::make_shared<State>();
+			return create(Configuration{});
+		}
+
+		[[nodiscard]] static Endpoints create(Configuration configuration)
+		{
+			auto state = std::make_shared<State>(std::move(configuration));
 
 			return {
 				.producer = Producer(state),
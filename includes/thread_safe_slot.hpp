@@ -23,6 +23,11 @@ namespace spk
 				latest.store(std::make_shared<value_type>(std::move(value)), std::memory_order_release);
 			}
 
+			void publish(pointer value)
+			{
+				latest.store(std::move(value), std::memory_order_release);
+			}
+
 			[[nodiscard]] pointer acquireLatest() const noexcept
 			{
 				return latest.load(std::memory_order_acquire);
@@ -49,6 +54,12 @@ namespace spk
 			{
 				_state->publish(std::move(value));
 			}
+
+			/** Publishes an already allocated value, letting the caller pick its allocation and deleter. */
+			void publish(pointer value)
+			{
+				_state->publish(std::move(value));
+			}
 		};
 
 		class Consumer
@@ -86,6 +97,11 @@ namespace spk
 			_state->publish(std::move(value));
 		}
 
+		void publish(pointer value)
+		{
+			_state->publish(std::move(value));
+		}
+
 		[[nodiscard]] pointer acquireLatest() const noexcept
 		{
 			return _state->acquireLatest();
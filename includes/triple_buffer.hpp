@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace spk
+{
+	template <typename TValue>
+	class TripleBuffer final
+	{
+		/**
+		 * Single-producer, single-consumer counterpart of ThreadSafeSlot over three preallocated values. The producer
+		 * writes into its back buffer and publishes it by exchanging one atomic index; the consumer swaps the freshest
+		 * buffer in the same way. Neither side locks nor allocates, and since buffers are rewritten rather than
+		 * replaced, the containers they own keep their capacity from one publication to the next.
+		 * The value returned by latest stays valid until the consumer calls update again.
+		 */
+	public:
+		using value_type = TValue;
+
+	private:
+		struct State
+		{
+			static constexpr std::size_t CacheLineSize = 64;
+			static constexpr std::uint8_t IndexMask = 0b011;
+			static constexpr std::uint8_t FreshBit = 0b100;
+
+			std::array<value_type, 3> buffers;
+			alignas(CacheLineSize) std::atomic<std::uint8_t> middle = 1;
+			alignas(CacheLineSize) std::uint8_t back = 0;
+			alignas(CacheLineSize) std::uint8_t front = 2;
+			bool hasValue = false;
+
+			void publish() noexcept
+			{
+				back = middle.exchange(back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+			}
+
+			[[nodiscard]] bool update() noexcept
+			{
+				if ((middle.load(std::memory_order_relaxed) & FreshBit) == 0)
+				{
+					return false;
+				}
+				front = middle.exchange(front, std::memory_order_acq_rel) & IndexMask;
+				hasValue = true;
+				return true;
+			}
+		};
+
+		std::shared_ptr<State> _state;
+
+	public:
+		class Producer
+		{
+		private:
+			std::shared_ptr<State> _state;
+
+			explicit Producer(std::shared_ptr<State> state) :
+				_state(std::move(state))
+			{
+			}
+
+			friend class TripleBuffer;
+
+		public:
+			/** Buffer owned by the producer until the next publish; it still holds whatever was written into it three publications ago. */
+			[[nodiscard]] value_type &back() noexcept
+			{
+				return _state->buffers[_state->back];
+			}
+
+			void publish() noexcept
+			{
+				_state->publish();
+			}
+
+			void publish(value_type value)
+			{
+				back() = std::move(value);
+				_state->publish();
+			}
+		};
+
+		class Consumer
+		{
+		private:
+			std::shared_ptr<State> _state;
+
+			explicit Consumer(std::shared_ptr<State> state) :
+				_state(std::move(state))
+			{
+			}
+
+			friend class TripleBuffer;
+
+		public:
+			/** Swaps in the most recently published buffer, if any was published since the previous call. */
+			[[nodiscard]] bool update() noexcept
+			{
+				return _state->update();
+			}
+
+			[[nodiscard]] const value_type *latest() const noexcept
+			{
+				return _state->hasValue ? &_state->buffers[_state->front] : nullptr;
+			}
+		};
+
+		struct Endpoints
+		{
+			Producer producer;
+			Consumer consumer;
+		};
+
+		[[nodiscard]] static Endpoints create()
+		{
+			auto state = std::make_shared<State>();
+
+			return {
+				.producer = Producer(state),
+				.consumer = Consumer(std::move(state))};
+		}
+	};
+}
@@ -4,14 +4,21 @@
 
 namespace spk
 {
+	class JobSystem;
 	struct Keyboard;
 	struct Mouse;
+	class TaskScheduler;
 
 	struct UpdateContext
 	{
 		std::chrono::steady_clock::duration time;
 		std::chrono::steady_clock::duration deltaTime;
+		float alpha;
 		const spk::Keyboard &keyboard;
 		const spk::Mouse &mouse;
+		/** Shared with every window; work fanned out from updateState must be joined before it returns. */
+		spk::JobSystem &jobs;
+		/** Resumes started Tasks on the update thread, before the windows are ticked. */
+		spk::TaskScheduler &tasks;
 	};
 }
@@ -4,24 +4,25 @@
 #include <variant>
 
 #include "window.hpp"
-#include "thread_safe_slot.hpp"
 #include "render_snapshot.hpp"
+#include "triple_buffer.hpp"
 #include "color.hpp"
 
 namespace spk
 {
 	struct StateRegistrationRequest
 	{
-		Window::Identifier windowIdentifier;
+		WindowHandle windowHandle;
 		spk::Color backgroundColor;
 		std::shared_ptr<Window::State> state;
-		spk::ThreadSafeSlot<spk::RenderSnapshot>::Producer renderSnapshotProducer;
+		spk::TripleBuffer<spk::RenderSnapshot>::Producer renderSnapshotProducer;
 		std::shared_ptr<std::atomic_bool> isRequested;
+		std::shared_ptr<Window::Latency> latency;
 	};
 
 	struct StateDeletionRequest
 	{
-		Window::Identifier windowIdentifier;
+		WindowHandle windowHandle;
 	};
 
 	using UpdateRequest = std::variant<
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+
+namespace spk
+{
+	class WakeSignal final
+	{
+		/**
+		 * Portable counterpart of WinAPI::WakeEvent used to park the worker threads.
+		 * A notification raised while nobody waits stays pending and is consumed by the next wait,
+		 * so a producer can never be lost between the moment a worker checks its inputs and the moment it sleeps.
+		 */
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Statistics
+		{
+			std::uint64_t wakeCount = 0;
+			Clock::duration totalLatency = Clock::duration::zero();
+			Clock::duration maximalLatency = Clock::duration::zero();
+
+			[[nodiscard]] Clock::duration averageLatency() const noexcept
+			{
+				return wakeCount != 0 ? totalLatency / static_cast<Clock::rep>(wakeCount) : Clock::duration::zero();
+			}
+		};
+
+	private:
+		mutable std::mutex _mutex;
+		std::condition_variable_any _condition;
+		bool _pending = false;
+		bool _waiting = false;
+		std::optional<Clock::time_point> _notifiedAt;
+		Statistics _statistics;
+
+		void _recordWake()
+		{
+			if (!_notifiedAt.has_value())
+				return;
+			const Clock::duration latency = Clock::now() - *_notifiedAt;
+			_notifiedAt.reset();
+			++_statistics.wakeCount;
+			_statistics.totalLatency += latency;
+			_statistics.maximalLatency = std::max(_statistics.maximalLatency, latency);
+		}
+
+		template <typename TWaiter>
+		bool _wait(TWaiter &&waiter)
+		{
+			std::unique_lock lock(_mutex);
+			_waiting = true;
+			const bool notified = waiter(lock);
+			_waiting = false;
+			if (notified)
+				_recordWake();
+			_pending = false;
+			return notified;
+		}
+
+	public:
+		WakeSignal() = default;
+		WakeSignal(const WakeSignal &) = delete;
+		WakeSignal(WakeSignal &&) = delete;
+
+		WakeSignal &operator=(const WakeSignal &) = delete;
+		WakeSignal &operator=(WakeSignal &&) = delete;
+
+		void notify()
+		{
+			{
+				const std::scoped_lock lock(_mutex);
+				if (_pending)
+					return;
+				_pending = true;
+				if (!_waiting)
+					return;
+				_notifiedAt = Clock::now();
+			}
+			_condition.notify_one();
+		}
+
+		bool wait(std::stop_token stopToken = {})
+		{
+			return _wait([&](std::unique_lock<std::mutex> &lock) {
+				return _condition.wait(lock, stopToken, [this] { return _pending; });
+			});
+		}
+
+		bool waitUntil(Clock::time_point deadline, std::stop_token stopToken = {})
+		{
+			return _wait([&](std::unique_lock<std::mutex> &lock) {
+				return _condition.wait_until(lock, stopToken, deadline, [this] { return _pending; });
+			});
+		}
+
+		[[nodiscard]] Statistics statistics() const
+		{
+			const std::scoped_lock lock(_mutex);
+			return _statistics;
+		}
+	};
+}
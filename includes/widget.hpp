@@ -1,5 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include "activable_trait.hpp"
 #include "cached_data.hpp"
 #include "inherence_trait.hpp"
@@ -14,6 +20,7 @@ namespace spk
 {
 	struct UpdateContext;
 	class Widget;
+	class WidgetSpatialIndex;
 
 	struct WidgetChildComparator
 	{
@@ -34,7 +41,11 @@ namespace spk
 		using ZOrder = float;
 
 	private:
+		friend class WidgetSpatialIndex;
+
 		InherenceTrait<Widget>::OnParentEditionContract _onParentEditedContract;
+		ActivableTrait::ActivationContract _onActivationContract;
+		ActivableTrait::DeactivationContract _onDeactivationContract;
 		ZOrder _zOrder = 0;
 		spk::CachedData<ZOrder> _absoluteZOrder;
 		spk::Rect2D _geometry{};
@@ -42,8 +53,20 @@ namespace spk
 		spk::Vector2 _sizeRatio{1.0f, 1.0f};
 		spk::CachedData<ViewRegion> _viewRegion;
 
+		Widget *_renderedParent = nullptr;
+		std::shared_ptr<const spk::RenderSnapshot::Fragment> _renderFragment;
+		std::shared_ptr<const spk::RenderSnapshot::Fragment> _subtreeRenderFragment;
+		bool _isRenderDirty = true;
+		bool _isSubtreeRenderDirty = true;
+		std::uint64_t _renderRevision = 0;
+		std::size_t _plannedRenderWork = 0;
+		const char *_profileName = nullptr;
+		WidgetSpatialIndex *_spatialIndex = nullptr;
+
 		void _invalidateViewRegion();
 		void _invalidateAbsoluteZOrder();
+		void _setSubtreeRenderDirty() noexcept;
+		void _markSubtreeRenderDirty();
 		void _computeRatio();
 		[[nodiscard]] spk::Rect2D _geometryFromRatio(const Widget &child) const;
 		void _resize(const spk::Rect2D &geometry);
@@ -51,7 +74,28 @@ namespace spk
 		template <typename TEvent>
 		void _propagate(TEvent &event, void (Widget::*handler)(TEvent &));
 
+		void _adoptSpatialIndex(WidgetSpatialIndex *spatialIndex);
+		void _markSpatialSubtreeDirty();
+		[[nodiscard]] bool _routesSpatially() const noexcept;
+		void _notifyHoverChange(const BaseEventRecord &source, const std::vector<Widget *> &left, const std::vector<Widget *> &entered);
+
+		template <typename TEvent>
+		void _route(TEvent &event, void (Widget::*handler)(TEvent &));
+
 		void _buildViewRegionCommands(spk::RenderSnapshot::Builder &builder);
+		void _rebuildRenderFragments(const spk::RenderSnapshot::Builder &builder);
+
+		struct RenderJobPlan
+		{
+			std::vector<Widget *> widgets;
+			std::vector<std::size_t> batchEnds;
+		};
+
+		static constexpr std::size_t SplitRenderWork = std::numeric_limits<std::size_t>::max();
+
+		[[nodiscard]] bool _needsRenderRebuild() const;
+		[[nodiscard]] std::size_t _planRenderJobs(RenderJobPlan &plan, std::size_t granularity);
+		void _rebuildRenderFragmentsInParallel(const spk::RenderSnapshot::Builder &builder);
 
 		virtual void _updateState(UpdateContext &context);
 		virtual void _buildRenderSnapshot(spk::RenderSnapshot::Builder &builder);
@@ -76,6 +120,15 @@ namespace spk
 		Widget(std::string name, Widget *parent);
 		virtual ~Widget();
 
+		/**
+		 * The commands emitted by _buildRenderSnapshot are cached between snapshots. A widget whose rendering depends
+		 * on anything other than its geometry, z-order or activation must call this whenever that state changes.
+		 */
+		void markRenderDirty();
+		[[nodiscard]] bool isRenderDirty() const noexcept;
+		/** Incremented each time a change invalidates the cached commands of this widget or of its descendants. */
+		[[nodiscard]] std::uint64_t renderRevision() const noexcept;
+
 		void setZOrder(ZOrder zOrder);
 		[[nodiscard]] ZOrder zOrder() const;
 		[[nodiscard]] ZOrder absoluteZOrder() const;
@@ -84,7 +137,15 @@ namespace spk
 		void resize(const spk::Rect2D &geometry);
 		[[nodiscard]] const spk::Rect2D &geometry() const noexcept;
 		[[nodiscard]] const ViewRegion &viewRegion() const;
+		[[nodiscard]] WidgetSpatialIndex *spatialIndex() const noexcept;
+		/** Name interned once for the profiler, so widget scopes record without hashing it; null unless profiling. */
+		[[nodiscard]] const char *profileName() const noexcept;
 
+		/**
+		 * On the root of a WidgetSpatialIndex, mouse events reach only the widgets under the cursor, in the order
+		 * propagation would have visited them, and MouseEntered/MouseLeft become per-widget hover changes derived
+		 * from the cursor position. Dispatched anywhere else, events propagate to the whole active subtree.
+		 */
 		void dispatch(WindowResizedEvent &event);
 		void dispatch(WindowMovedEvent &event);
 		void dispatch(WindowFocusGainedEvent &event);
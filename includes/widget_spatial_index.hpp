@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "vector2.hpp"
+
+namespace spk
+{
+	class Widget;
+
+	class WidgetSpatialIndex final
+	{
+		/**
+		 * Uniform grid over the scissor rectangles of a widget tree, letting the tree's root deliver mouse events to
+		 * the widgets under the cursor only. Widgets flag themselves dirty when their view region, activation or
+		 * parent changes; dirty widgets are re-bucketed lazily on the next query, so a burst of layout changes costs
+		 * one pass. Inactive subtrees are left out of the grid, and z-order is read at query time from the children
+		 * order, which the tree keeps sorted. Meant to be used from the thread updating the tree.
+		 */
+	public:
+		static constexpr std::int32_t DefaultCellSize = 64;
+
+		struct Statistics
+		{
+			std::size_t widgetCount = 0;
+			std::size_t indexedWidgetCount = 0;
+			std::size_t occupiedCellCount = 0;
+		};
+
+		struct HoverChange
+		{
+			std::vector<Widget *> left;
+			std::vector<Widget *> entered;
+		};
+
+	private:
+		struct Entry
+		{
+			bool isDirty = false;
+			bool isIndexed = false;
+			spk::Vector2Int firstCell;
+			spk::Vector2Int lastCell;
+		};
+
+		Widget &_root;
+		std::int32_t _cellSize;
+		std::unordered_map<std::uint64_t, std::vector<Widget *>> _cells;
+		std::unordered_map<Widget *, Entry> _entries;
+		std::vector<Widget *> _dirtyWidgets;
+		std::vector<Widget *> _hoveredWidgets;
+
+		[[nodiscard]] static std::uint64_t _cellKey(std::int32_t x, std::int32_t y) noexcept;
+		[[nodiscard]] std::int32_t _cellCoordinate(std::int32_t value) const noexcept;
+		[[nodiscard]] bool _isReachable(const Widget &widget) const;
+		void _link(Widget &widget, Entry &entry);
+		void _unlink(Widget &widget, Entry &entry);
+		void _flush();
+		void _sortInDispatchOrder(std::vector<Widget *> &widgets) const;
+
+	public:
+		/** Indexes root and its current descendants; widgets attached to root later are picked up automatically. */
+		explicit WidgetSpatialIndex(Widget &root, std::int32_t cellSize = DefaultCellSize);
+		WidgetSpatialIndex(const WidgetSpatialIndex &) = delete;
+		WidgetSpatialIndex &operator=(const WidgetSpatialIndex &) = delete;
+		~WidgetSpatialIndex();
+
+		[[nodiscard]] Widget &root() const noexcept;
+
+		void insert(Widget &widget);
+		void remove(Widget &widget);
+		void markDirty(Widget &widget);
+
+		/** Active widgets whose scissor contains position, deepest first, in the order Widget::dispatch visits them. */
+		[[nodiscard]] std::vector<Widget *> query(const spk::Vector2Int &position);
+
+		/** Replaces the hovered widgets by hits, the result of a query, and reports which ones left and entered. */
+		[[nodiscard]] HoverChange updateHover(const std::vector<Widget *> &hits);
+		/** Forgets every hovered widget, returning them, as when the cursor leaves the window. */
+		[[nodiscard]] std::vector<Widget *> releaseHover();
+		[[nodiscard]] const std::vector<Widget *> &hoveredWidgets() const noexcept;
+
+		[[nodiscard]] Statistics statistics() const;
+	};
+}
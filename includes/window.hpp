@@ -1,11 +1,16 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
 #include "focus_mode.hpp"
+#include "latency_histogram.hpp"
+#include "platform.hpp"
 #include "rect2d.hpp"
 #include "color.hpp"
+#include "window_handle.hpp"
 
 #include "gpu_resource.hpp"
 #include "gpu_resource_collection.hpp"
@@ -13,19 +18,18 @@
 namespace spk
 {
 	class Application;
+	class JobSystem;
+	class RenderBackend;
 	class Widget;
+	struct SoftwareFramebuffer;
 	struct Keyboard;
 	struct Mouse;
 
-	namespace WinAPI
-	{
-		class Frame;
-	}
-
 	class Window
 	{
 	public:
 		using Identifier = std::string;
+		using Handle = WindowHandle;
 
 		enum class LifeCycle
 		{
@@ -35,6 +39,41 @@ namespace spk
 			Released
 		};
 
+		struct UpdateStatistics
+		{
+			using Clock = std::chrono::steady_clock;
+
+			std::uint64_t updateCount = 0;
+			Clock::duration lastDuration = Clock::duration::zero();
+			Clock::duration totalDuration = Clock::duration::zero();
+			Clock::duration maximalDuration = Clock::duration::zero();
+
+			[[nodiscard]] Clock::duration averageDuration() const noexcept
+			{
+				return updateCount != 0 ? totalDuration / static_cast<Clock::rep>(updateCount) : Clock::duration::zero();
+			}
+		};
+
+		struct Latency
+		{
+			/**
+			 * Pipeline latencies of one window. The updater records the first two and the renderer the last two; every
+			 * snapshot is measured against the newest input it reflects.
+			 */
+			spk::LatencyHistogram inputToDispatch;
+			spk::LatencyHistogram dispatchToSnapshot;
+			spk::LatencyHistogram snapshotToPresent;
+			spk::LatencyHistogram inputToPresent;
+		};
+
+		struct LatencyStatistics
+		{
+			spk::LatencyHistogram::Summary inputToDispatch;
+			spk::LatencyHistogram::Summary dispatchToSnapshot;
+			spk::LatencyHistogram::Summary snapshotToPresent;
+			spk::LatencyHistogram::Summary inputToPresent;
+		};
+
 		struct Configuration
 		{
 			std::string title;
@@ -63,8 +102,8 @@ namespace spk
 			Native &operator=(Native &&) = delete;
 
 			[[nodiscard]] LifeCycle lifeCycle() const noexcept;
-			[[nodiscard]] WinAPI::Frame &frame() noexcept;
-			[[nodiscard]] const WinAPI::Frame &frame() const noexcept;
+			[[nodiscard]] Platform::Frame &frame() noexcept;
+			[[nodiscard]] const Platform::Frame &frame() const noexcept;
 
 			void markReady() noexcept;
 			void beginRelease() noexcept;
@@ -91,6 +130,9 @@ namespace spk
 			[[nodiscard]] const Widget *focusedWidget(FocusMode::Channel channel) const noexcept;
 
 			void setBackgroundColor(const spk::Color& backgroundColor);
+			[[nodiscard]] std::uint64_t renderRevision() const noexcept;
+			void recordUpdate(UpdateStatistics::Clock::duration duration);
+			[[nodiscard]] UpdateStatistics updateStatistics() const;
 
 			void takeFocus(FocusMode::Channel channel, Widget *widget) noexcept;
 			void releaseFocus(FocusMode::Channel channel, Widget *widget) noexcept;
@@ -118,7 +160,8 @@ namespace spk
 			std::unique_ptr<Impl> _impl;
 
 		public:
-			explicit Surface(const Window::Identifier &windowID);
+			/** Backends rendering on the CPU split their work across jobSystem; GPU backends ignore it. */
+			explicit Surface(const Window::Identifier &windowID, spk::JobSystem *jobSystem = nullptr);
 			Surface(const Surface &) = delete;
 			Surface(Surface &&) = delete;
 			~Surface();
@@ -127,10 +170,12 @@ namespace spk
 			Surface &operator=(Surface &&) = delete;
 
 			[[nodiscard]] LifeCycle lifeCycle() const noexcept;
-			void create(const WinAPI::Frame &frame);
+			void create(const Platform::Frame &frame);
 			void destroy();
 			void makeCurrent();
 			void present();
+			[[nodiscard]] RenderBackend &backend() noexcept;
+			[[nodiscard]] std::shared_ptr<const SoftwareFramebuffer> capture() const;
 
 			void setGeometry(const spk::Rect2D &geometry) noexcept;
 			[[nodiscard]] const spk::Rect2D& geometry() const noexcept;
@@ -139,17 +184,26 @@ namespace spk
 		};
 
 	private:
+		Handle _handle;
 		std::shared_ptr<Native> _native;
 		std::shared_ptr<State> _state;
 		std::shared_ptr<Surface> _surface;
+		std::shared_ptr<Latency> _latency;
 
 	public:
-		Window(std::shared_ptr<Native> native, std::shared_ptr<State> state, std::shared_ptr<Surface> surface);
+		Window(Handle handle, std::shared_ptr<Native> native, std::shared_ptr<State> state, std::shared_ptr<Surface> surface,
+			std::shared_ptr<Latency> latency);
+
+		[[nodiscard]] Handle handle() const noexcept;
 
 		[[nodiscard]] bool isClosing() const noexcept;
 		[[nodiscard]] bool isClosed() const noexcept;
 		[[nodiscard]] Widget &root() noexcept;
 		[[nodiscard]] const Widget &root() const noexcept;
 		[[nodiscard]] const spk::Rect2D &geometry() const noexcept;
+		[[nodiscard]] std::shared_ptr<const SoftwareFramebuffer> capture() const;
+		/** Time the updater spent on this window's update steps and snapshot builds, measured on whichever thread ran them. */
+		[[nodiscard]] UpdateStatistics updateStatistics() const;
+		[[nodiscard]] LatencyStatistics latencyStatistics() const;
 	};
 }
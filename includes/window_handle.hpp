@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+
+namespace spk
+{
+	struct WindowHandle
+	{
+		/**
+		 * Compact identity interned by Application::createWindow and carried by every record and request in place of
+		 * the window name. The generation is bumped whenever an index is recycled, so a handle to a closed window
+		 * never resolves to the window that later reuses its slot.
+		 */
+		static constexpr std::uint32_t InvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+		std::uint32_t index = InvalidIndex;
+		std::uint32_t generation = 0;
+
+		[[nodiscard]] constexpr bool isValid() const noexcept
+		{
+			return index != InvalidIndex;
+		}
+
+		[[nodiscard]] std::string toString() const
+		{
+			return std::to_string(index) + "#" + std::to_string(generation);
+		}
+
+		friend constexpr bool operator==(const WindowHandle &, const WindowHandle &) noexcept = default;
+	};
+}
+
+template <>
+struct std::hash<spk::WindowHandle>
+{
+	[[nodiscard]] std::size_t operator()(const spk::WindowHandle &handle) const noexcept
+	{
+		return std::hash<std::uint64_t>{}((static_cast<std::uint64_t>(handle.generation) << 32) | handle.index);
+	}
+};
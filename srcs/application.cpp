@@ -2,9 +2,12 @@
 
 #include "internal/application_internal.hpp"
 
+#include <utility>
+
 namespace spk
 {
-	Application::Application() : _impl(std::make_unique<Impl>()) {}
+	Application::Application() : Application(Configuration{}) {}
+	Application::Application(const Configuration &configuration) : _impl(std::make_unique<Impl>(configuration)) {}
 	Application::~Application() = default;
 
 	Window &Application::window(const Window::Identifier &identifier)
@@ -32,8 +35,38 @@ namespace spk
 		_impl->quit(exitCode);
 	}
 
+	void Application::inject(EventRecord record)
+	{
+		_impl->inject(std::move(record));
+	}
+
+	void Application::inject(std::vector<EventRecord> records)
+	{
+		_impl->inject(std::move(records));
+	}
+
+	void Application::startRecording(std::shared_ptr<EventRecordWriter> writer)
+	{
+		_impl->startRecording(std::move(writer));
+	}
+
+	void Application::stopRecording()
+	{
+		_impl->stopRecording();
+	}
+
 	int Application::run()
 	{
 		return _impl->run();
 	}
+
+	Application::WakeStatistics Application::wakeStatistics() const
+	{
+		return _impl->wakeStatistics();
+	}
+
+	Application::EventChannelStatistics Application::eventChannelStatistics() const
+	{
+		return _impl->eventChannelStatistics();
+	}
 }
@@ -2,33 +2,72 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <optional>
 #include <stdexcept>
 #include <utility>
+#include <variant>
 
 namespace spk
 {
-	Application::Channels::Channels() :
-		eventRecords(spk::ThreadSafeFIFO<EventRecord>::create()),
-		platformRequests(spk::ThreadSafeFIFO<PlatformRequest>::create()),
-		updateRequests(spk::ThreadSafeFIFO<UpdateRequest>::create()),
-		renderRequests(spk::ThreadSafeFIFO<RenderRequest>::create())
+	namespace
 	{
+		[[nodiscard]] std::optional<std::size_t> eventCoalescingKey(const EventRecord &record)
+		{
+			// Only records whose latest value supersedes the previous ones may be merged; wheel deltas must add up.
+			if (!std::holds_alternative<MouseMovedRecord>(record) && !std::holds_alternative<WindowResizedRecord>(record))
+				return std::nullopt;
+
+			const Window::Handle handle = std::visit([](const auto &value) { return value.windowHandle; }, record);
+			return (static_cast<std::size_t>(handle.index) << 32 | handle.generation) * std::variant_size_v<EventRecord> + record.index();
+		}
 	}
 
-	Application::Impl::Impl() : Impl(Channels{}) {}
+	Application::Channels::Channels(const Configuration &configuration) :
+		eventRecords(EventRecordFIFO::create(EventRecordFIFO::Configuration{
+			.capacity = configuration.eventChannelCapacity,
+			.overflowPolicy = EventRecordFIFO::OverflowPolicy::Coalesce,
+			.coalescingKey = eventCoalescingKey})),
+		injectedRecords(InjectedRecordFIFO::create()),
+		platformRequests(PlatformRequestFIFO::create()),
+		updateRequests(UpdateRequestFIFO::create()),
+		renderRequests(RenderRequestFIFO::create())
+	{
+	}
 
-	Application::Impl::Impl(Channels channels) :
+	Application::Impl::Impl(const Configuration &configuration) : Impl(configuration, Channels(configuration)) {}
+
+	Application::Impl::Impl(const Configuration &configuration, Channels channels) :
+		_configuration(configuration),
+		_pacer(configuration.pacing),
+		_jobSystem(configuration.jobWorkerCount),
 		_platformRequestProducer(channels.platformRequests.producer, _platformWakeEvent),
-		_updateRequestProducer(channels.updateRequests.producer),
-		_renderRequestProducer(channels.renderRequests.producer),
+		_injectedRecordProducer(std::move(channels.injectedRecords.producer), _platformWakeEvent),
+		_updateRequestProducer(channels.updateRequests.producer, _updaterWakeSignal),
+		_renderRequestProducer(channels.renderRequests.producer, _rendererWakeSignal),
 		_platform(
 			_platformWakeEvent,
 			std::move(channels.platformRequests.consumer),
-			std::move(channels.eventRecords.producer),
-			std::move(channels.updateRequests.producer),
-			std::move(channels.renderRequests.producer)),
-		_updater(std::move(channels.eventRecords.consumer), std::move(channels.updateRequests.consumer)),
-		_renderer(_platformWakeEvent, std::move(channels.renderRequests.consumer), std::move(channels.platformRequests.producer))
+			std::move(channels.injectedRecords.consumer),
+			EventRecordProducer(std::move(channels.eventRecords.producer), _updaterWakeSignal),
+			UpdateRequestProducer(std::move(channels.updateRequests.producer), _updaterWakeSignal),
+			RenderRequestProducer(std::move(channels.renderRequests.producer), _rendererWakeSignal)),
+		_updater(
+			_updaterWakeSignal,
+			_rendererWakeSignal,
+			_pacer,
+			std::move(channels.eventRecords.consumer),
+			std::move(channels.updateRequests.consumer),
+			_jobSystem,
+			configuration.parallelSnapshotBuild,
+			configuration.snapshotBuildGranularity,
+			configuration.parallelWindowUpdate),
+		_renderer(
+			_rendererWakeSignal,
+			_updaterWakeSignal,
+			_pacer,
+			_platformWakeEvent,
+			std::move(channels.renderRequests.consumer),
+			std::move(channels.platformRequests.producer))
 	{
 	}
 
@@ -46,12 +85,21 @@ namespace spk
 	}
 
 	template <typename TRuntime>
-	void Application::Impl::_runWorker(TRuntime &runtime, std::stop_token stopToken)
+	void Application::Impl::_runWorker(TRuntime &runtime, [[maybe_unused]] const char *threadName, std::stop_token stopToken)
 	{
+		SPARKLE_PROFILE_THREAD(threadName);
+		std::stop_callback stopCallback(_stopSource.get_token(), [&runtime] {
+			runtime.wake();
+		});
+
 		try
 		{
 			while (!stopToken.stop_requested() && !_stopSource.stop_requested())
+			{
 				runtime.executeOnce();
+				if (_configuration.schedulingMode == SchedulingMode::EventDriven)
+					runtime.waitForActivity(stopToken);
+			}
 		}
 		catch (...)
 		{
@@ -61,9 +109,9 @@ namespace spk
 	}
 
 	template <typename TRuntime>
-	std::jthread Application::Impl::_startWorker(TRuntime &runtime)
+	std::jthread Application::Impl::_startWorker(TRuntime &runtime, const char *threadName)
 	{
-		return std::jthread([this, &runtime](std::stop_token stopToken) { _runWorker(runtime, stopToken); });
+		return std::jthread([this, &runtime, threadName](std::stop_token stopToken) { _runWorker(runtime, threadName, stopToken); });
 	}
 
 	void Application::Impl::_reportWorkerFailure(std::exception_ptr exception)
@@ -97,37 +145,61 @@ namespace spk
 			updaterThread.join();
 		if (rendererThread.joinable())
 			rendererThread.join();
+		_jobSystem.stop();
+	}
+
+	Window::Handle Application::Impl::_acquireWindowHandle()
+	{
+		if (_freeWindowHandleIndexes.empty())
+		{
+			_windowHandleGenerations.push_back(0);
+			return Window::Handle{.index = static_cast<std::uint32_t>(_windowHandleGenerations.size() - 1), .generation = 0};
+		}
+		const std::uint32_t index = _freeWindowHandleIndexes.back();
+		_freeWindowHandleIndexes.pop_back();
+		return Window::Handle{.index = index, .generation = _windowHandleGenerations[index]};
+	}
+
+	void Application::Impl::_releaseWindowHandle(Window::Handle handle)
+	{
+		++_windowHandleGenerations[handle.index];
+		_freeWindowHandleIndexes.push_back(handle.index);
 	}
 
 	void Application::Impl::_registerWindowObjects(
-		const Window::Identifier &identifier, const Window::Configuration &configuration,
+		Window::Handle handle, const Window::Configuration &configuration,
 		std::shared_ptr<Window::Native> native, std::shared_ptr<Window::State> state,
-		std::shared_ptr<Window::Surface> surface, spk::ThreadSafeSlot<spk::RenderSnapshot>::Endpoints channel,
-		std::shared_ptr<std::atomic_bool> isRenderSnapshotRequested)
+		std::shared_ptr<Window::Surface> surface, spk::TripleBuffer<spk::RenderSnapshot>::Endpoints channel,
+		std::shared_ptr<std::atomic_bool> isRenderSnapshotRequested, std::shared_ptr<Window::Latency> latency)
 	{
 		_updateRequestProducer.publish(StateRegistrationRequest{
-			.windowIdentifier = identifier, .backgroundColor = configuration.backgroundColor, .state = std::move(state), .renderSnapshotProducer = std::move(channel.producer), .isRequested = isRenderSnapshotRequested});
+			.windowHandle = handle, .backgroundColor = configuration.backgroundColor, .state = std::move(state), .renderSnapshotProducer = std::move(channel.producer), .isRequested = isRenderSnapshotRequested, .latency = latency});
 		_renderRequestProducer.publish(SurfaceRegistrationRequest{
-			.windowIdentifier = identifier, .surface = std::move(surface), .renderSnapshotConsumer = std::move(channel.consumer), .isRequested = isRenderSnapshotRequested});
+			.windowHandle = handle, .surface = std::move(surface), .renderSnapshotConsumer = std::move(channel.consumer), .isRequested = isRenderSnapshotRequested, .latency = std::move(latency)});
 		_platformRequestProducer.publish(NativeRegistrationRequest{
-			.windowIdentifier = identifier, .configuration = configuration, .native = std::move(native)});
+			.windowHandle = handle, .configuration = configuration, .native = std::move(native)});
 	}
 
-	void Application::Impl::_requestWindowClosure(const Window::Identifier &identifier)
+	void Application::Impl::_requestWindowClosure(Window::Handle handle)
 	{
-		_updateRequestProducer.publish(StateDeletionRequest{.windowIdentifier = identifier});
-		_renderRequestProducer.publish(SurfaceDeletionRequest{.windowIdentifier = identifier});
+		_updateRequestProducer.publish(StateDeletionRequest{.windowHandle = handle});
+		_renderRequestProducer.publish(SurfaceDeletionRequest{.windowHandle = handle});
 	}
 
 	void Application::Impl::_requestAllWindowClosures()
 	{
 		for (const auto &[identifier, window] : _windows)
-			_requestWindowClosure(identifier);
+			_requestWindowClosure(window->handle());
 	}
 
 	void Application::Impl::_removeClosedWindows()
 	{
-		std::erase_if(_windows, [](const auto &entry) { return entry.second->isClosed(); });
+		std::erase_if(_windows, [this](const auto &entry) {
+			if (!entry.second->isClosed())
+				return false;
+			_releaseWindowHandle(entry.second->handle());
+			return true;
+		});
 	}
 
 	void Application::Impl::_finishExecution()
@@ -153,8 +225,12 @@ namespace spk
 
 	void Application::Impl::_runPlatform()
 	{
+		SPARKLE_PROFILE_THREAD("platform");
 		bool closureRequested = false;
+		// The updater stops draining events once a stop is requested, so the channel is closed at the same time: a
+		// platform thread blocked on a full channel is released instead of waiting forever.
 		std::stop_callback stopCallback(_stopSource.get_token(), [this] {
+			_updater.closeEventChannel();
 			_platformWakeEvent.notify();
 		});
 
@@ -164,7 +240,7 @@ namespace spk
 			_removeClosedWindows();
 			_processApplicationState(closureRequested);
 			if (!_stopSource.stop_requested())
-				_platform.waitForActivity();
+				_platform.waitForActivity(_stopSource.get_token());
 		}
 	}
 
@@ -197,25 +273,59 @@ namespace spk
 
 		auto native = std::make_shared<Window::Native>(identifier);
 		auto state = std::make_shared<Window::State>(identifier);
-		auto surface = std::make_shared<Window::Surface>(identifier);
-		auto window = std::make_unique<Window>(native, state, surface);
+		auto surface = std::make_shared<Window::Surface>(identifier, &_jobSystem);
+		const Window::Handle handle = _acquireWindowHandle();
+		auto latency = std::make_shared<Window::Latency>();
+		auto window = std::make_unique<Window>(handle, native, state, surface, latency);
 
 		Window &result = *window;
 		_windows.emplace(identifier, std::move(window));
-		_registerWindowObjects(identifier, configuration, std::move(native), std::move(state), std::move(surface),
-			spk::ThreadSafeSlot<spk::RenderSnapshot>::create(), std::make_shared<std::atomic_bool>(true));
+		_registerWindowObjects(handle, configuration, std::move(native), std::move(state), std::move(surface),
+			spk::TripleBuffer<spk::RenderSnapshot>::create(), std::make_shared<std::atomic_bool>(true), std::move(latency));
 		return result;
 	}
 
 	void Application::Impl::closeWindow(const Window::Identifier &identifier)
 	{
-		static_cast<void>(window(identifier));
-		_requestWindowClosure(identifier);
+		_requestWindowClosure(window(identifier).handle());
 	}
 
 	void Application::Impl::quit(int exitCode)
 	{
 		_exitCode.store(exitCode);
+		_platformWakeEvent.notify();
+	}
+
+	void Application::Impl::inject(EventRecord record)
+	{
+		_injectedRecordProducer.publish(std::move(record));
+	}
+
+	void Application::Impl::inject(std::vector<EventRecord> records)
+	{
+		_injectedRecordProducer.publishBatch(records);
+	}
+
+	void Application::Impl::startRecording(std::shared_ptr<EventRecordWriter> writer)
+	{
+		_platformRequestProducer.publish(EventRecordingRequest{.writer = std::move(writer)});
+	}
+
+	void Application::Impl::stopRecording()
+	{
+		_platformRequestProducer.publish(EventRecordingRequest{.writer = nullptr});
+	}
+
+	Application::WakeStatistics Application::Impl::wakeStatistics() const
+	{
+		return WakeStatistics{
+			.updater = _updaterWakeSignal.statistics(),
+			.renderer = _rendererWakeSignal.statistics()};
+	}
+
+	Application::EventChannelStatistics Application::Impl::eventChannelStatistics() const
+	{
+		return _updater.eventChannelStatistics();
 	}
 
 	int Application::Impl::run()
@@ -224,8 +334,9 @@ namespace spk
 		std::jthread rendererThread;
 		try
 		{
-			updaterThread = _startWorker(_updater);
-			rendererThread = _startWorker(_renderer);
+			_jobSystem.start();
+			updaterThread = _startWorker(_updater, "updater");
+			rendererThread = _startWorker(_renderer, "renderer");
 			_runPlatform();
 			_stopAndJoinWorkers(updaterThread, rendererThread);
 			_rethrowWorkerFailure();
@@ -1,44 +1,10 @@
 #include "internal/application_internal.hpp"
 
-#include <windowsx.h>
-
-#include <string>
-#include <system_error>
 #include <utility>
 #include <variant>
 
 namespace spk
 {
-	Application::PlatformRuntime::PlatformRuntime(
-		WinAPI::WakeEvent &wakeEvent,
-		spk::ThreadSafeFIFO<PlatformRequest>::Consumer platformRequestConsumer,
-		spk::ThreadSafeFIFO<EventRecord>::Producer eventRecordProducer,
-		spk::ThreadSafeFIFO<UpdateRequest>::Producer updateRequestProducer,
-		spk::ThreadSafeFIFO<RenderRequest>::Producer renderRequestProducer) :
-		_wakeEvent(wakeEvent),
-		_windowClass(std::string(ClassIdentifier)),
-		_platformRequestConsumer(std::move(platformRequestConsumer)),
-		_eventRecordProducer(std::move(eventRecordProducer)),
-		_updateRequestProducer(std::move(updateRequestProducer)),
-		_renderRequestProducer(std::move(renderRequestProducer))
-	{
-	}
-
-	void Application::PlatformRuntime::_createNative(const NativeRegistrationRequest &request)
-	{
-		const Identifier identifier = request.windowIdentifier;
-		request.native->frame().create(_windowClass, WinAPI::Frame::CreationInfo{
-			.title = request.configuration.title,
-			.x = request.configuration.area.anchor.x,
-			.y = request.configuration.area.anchor.y,
-			.width = request.configuration.area.size.x,
-			.height = request.configuration.area.size.y,
-			.messageHandler = [this, identifier](HWND handle, UINT message, WPARAM wParam, LPARAM lParam) {
-				return _processMessage(identifier, handle, message, wParam, lParam);
-			}});
-		request.native->markReady();
-	}
-
 	void Application::PlatformRuntime::_destroyNative(Window::Native &native)
 	{
 		if (native.lifeCycle() == Window::LifeCycle::Released)
@@ -48,60 +14,20 @@ namespace spk
 		native.markReleased();
 	}
 
-	template <typename TRecord>
-	void Application::PlatformRuntime::_publish(const Identifier &identifier, TRecord record)
-	{
-		record.windowIdentifier = identifier;
-		_eventRecordProducer.publish(EventRecord(std::move(record)));
-	}
-
-	spk::Vector2Int Application::PlatformRuntime::_mousePosition(LPARAM lParam) noexcept
-	{
-		return {GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam)};
-	}
-
-	spk::Mouse::Button Application::PlatformRuntime::_mouseButton(UINT message) noexcept
-	{
-		switch (message)
-		{
-		case WM_RBUTTONDOWN:
-		case WM_RBUTTONUP:
-		case WM_RBUTTONDBLCLK: return spk::Mouse::Right;
-		case WM_MBUTTONDOWN:
-		case WM_MBUTTONUP:
-		case WM_MBUTTONDBLCLK: return spk::Mouse::Middle;
-		default: return spk::Mouse::Left;
-		}
-	}
-
-	spk::Keyboard::Key Application::PlatformRuntime::_key(WPARAM wParam, LPARAM lParam) noexcept
-	{
-		UINT key = static_cast<UINT>(wParam);
-		if (key == VK_SHIFT)
-			key = ::MapVirtualKeyW((lParam >> 16) & 0xFF, MAPVK_VSC_TO_VK_EX);
-		else if (key == VK_CONTROL)
-			key = (lParam & (1 << 24)) ? VK_RCONTROL : VK_LCONTROL;
-		else if (key == VK_MENU)
-			key = (lParam & (1 << 24)) ? VK_RMENU : VK_LMENU;
-		return key < spk::Keyboard::NbKey ? static_cast<spk::Keyboard::Key>(key) : spk::Keyboard::Unknown;
-	}
-
 	void Application::PlatformRuntime::_consume(const NativeRegistrationRequest &request)
 	{
-		append(request.windowIdentifier, request.native);
+		append(request.windowHandle, request.native);
 		_createNative(request);
 		_renderRequestProducer.publish(SurfaceCreationRequest{
-			.windowIdentifier = request.windowIdentifier,
+			.windowHandle = request.windowHandle,
 			.native = request.native});
 	}
 
-	void Application::PlatformRuntime::_consume(const NativeDeletionRequest &request)
+	void Application::PlatformRuntime::_consume(const EventRecordingRequest &request)
 	{
-		if (!contains(request.windowIdentifier))
-			return;
-		_mouseInsideWindows.erase(request.windowIdentifier);
-		_destroyNative(object(request.windowIdentifier));
-		remove(request.windowIdentifier);
+		if (_eventRecordWriter != nullptr)
+			_eventRecordWriter->flush();
+		_eventRecordWriter = request.writer;
 	}
 
 	void Application::PlatformRuntime::_consumeRequests()
@@ -110,169 +36,52 @@ namespace spk
 			std::visit([this](const auto &value) { _consume(value); }, request);
 	}
 
-	Application::PlatformRuntime::MessageResult Application::PlatformRuntime::_processWindowMessage(
-		const Identifier &identifier, UINT message, LPARAM lParam)
-	{
-		switch (message)
-		{
-		case WM_MOVE: _publish(identifier, WindowMovedRecord{}); return 0;
-		case WM_SIZE:
-		{
-			const spk::Vector2UInt newSize{
-				static_cast<spk::Vector2UInt::value_type>(LOWORD(lParam)),
-				static_cast<spk::Vector2UInt::value_type>(HIWORD(lParam))
-			};
-
-			_renderRequestProducer.publish(SurfaceResizeRequest{
-				.windowIdentifier = identifier,
-				.newSize = newSize
-			});
-
-			WindowResizedRecord record;
-			record.size = newSize;
-			_publish(identifier, std::move(record));
-			return 0;
-		}
-		case WM_SETFOCUS: _publish(identifier, WindowFocusGainedRecord{}); return 0;
-		case WM_KILLFOCUS: _publish(identifier, WindowFocusLostRecord{}); return 0;
-		default: return std::nullopt;
-		}
-	}
-
-	void Application::PlatformRuntime::_trackMouseLeave(HWND handle)
-	{
-		TRACKMOUSEEVENT event{.cbSize = sizeof(TRACKMOUSEEVENT), .dwFlags = TME_LEAVE, .hwndTrack = handle};
-		if (::TrackMouseEvent(&event) == FALSE)
-			throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), "TrackMouseEvent");
-	}
-
-	void Application::PlatformRuntime::_processMouseMove(const Identifier &identifier, HWND handle, LPARAM lParam)
-	{
-		if (_mouseInsideWindows.insert(identifier).second)
-		{
-			_trackMouseLeave(handle);
-			_publish(identifier, MouseEnteredRecord{});
-		}
-		MouseMovedRecord record;
-		record.position = _mousePosition(lParam);
-		_publish(identifier, std::move(record));
-	}
-
-	void Application::PlatformRuntime::_processMouseWheel(const Identifier &identifier, WPARAM wParam, bool horizontal)
-	{
-		const float delta = static_cast<float>(GET_WHEEL_DELTA_WPARAM(wParam)) / static_cast<float>(WHEEL_DELTA);
-		MouseWheelScrolledRecord record;
-		record.value = horizontal ? spk::Vector2(delta, 0.0f) : spk::Vector2(0.0f, delta);
-		_publish(identifier, std::move(record));
-	}
-
-	template <typename TRecord>
-	void Application::PlatformRuntime::_publishMouseButton(const Identifier &identifier, UINT message)
-	{
-		TRecord record;
-		record.button = _mouseButton(message);
-		_publish(identifier, std::move(record));
-	}
-
-	void Application::PlatformRuntime::_processMouseLeave(const Identifier &identifier)
-	{
-		_mouseInsideWindows.erase(identifier);
-		_publish(identifier, MouseLeftRecord{});
-	}
-
-	Application::PlatformRuntime::MessageResult Application::PlatformRuntime::_processMouseButtonMessage(
-		const Identifier &identifier, HWND handle, UINT message, WPARAM wParam)
+	void Application::PlatformRuntime::_publishEvent(EventRecord record)
 	{
-		switch (message)
-		{
-		case WM_LBUTTONDOWN: case WM_RBUTTONDOWN: case WM_MBUTTONDOWN:
-			::SetCapture(handle); _publishMouseButton<MouseButtonPressedRecord>(identifier, message); return 0;
-		case WM_LBUTTONUP: case WM_RBUTTONUP: case WM_MBUTTONUP:
-			_publishMouseButton<MouseButtonReleasedRecord>(identifier, message);
-			if ((wParam & (MK_LBUTTON | MK_RBUTTON | MK_MBUTTON)) == 0)
-				::ReleaseCapture();
-			return 0;
-		case WM_LBUTTONDBLCLK: case WM_RBUTTONDBLCLK: case WM_MBUTTONDBLCLK:
-			::SetCapture(handle); _publishMouseButton<MouseButtonDoubleClickedRecord>(identifier, message); return 0;
-		default: return std::nullopt;
-		}
-	}
-
-	Application::PlatformRuntime::MessageResult Application::PlatformRuntime::_processMouseMessage(
-		const Identifier &identifier, HWND handle, UINT message, WPARAM wParam, LPARAM lParam)
-	{
-		if (message == WM_MOUSEMOVE)
-		{
-			_processMouseMove(identifier, handle, lParam);
-			return 0;
-		}
-		if (message == WM_MOUSELEAVE)
-		{
-			_processMouseLeave(identifier);
-			return 0;
-		}
-		if (message == WM_MOUSEWHEEL || message == WM_MOUSEHWHEEL)
-		{
-			_processMouseWheel(identifier, wParam, message == WM_MOUSEHWHEEL);
-			return 0;
-		}
-		return _processMouseButtonMessage(identifier, handle, message, wParam);
+		if (_eventRecordWriter != nullptr)
+			_eventRecordWriter->write(record);
+		_eventRecordProducer.publish(std::move(record));
 	}
 
-	template <typename TRecord>
-	void Application::PlatformRuntime::_publishKey(const Identifier &identifier, WPARAM wParam, LPARAM lParam)
+	void Application::PlatformRuntime::_publishEvents(std::span<EventRecord> records)
 	{
-		TRecord record;
-		record.key = _key(wParam, lParam);
-		_publish(identifier, std::move(record));
+		if (_eventRecordWriter != nullptr)
+			_eventRecordWriter->write(records);
+		_eventRecordProducer.publishBatch(records);
 	}
 
-	Application::PlatformRuntime::MessageResult Application::PlatformRuntime::_processKeyboardMessage(
-		const Identifier &identifier, HWND handle, UINT message, WPARAM wParam, LPARAM lParam)
+	void Application::PlatformRuntime::_inject(std::span<EventRecord> records)
 	{
-		switch (message)
-		{
-		case WM_KEYDOWN: _publishKey<KeyPressedRecord>(identifier, wParam, lParam); return 0;
-		case WM_KEYUP: _publishKey<KeyReleasedRecord>(identifier, wParam, lParam); return 0;
-		case WM_SYSKEYDOWN:
-			_publishKey<KeyPressedRecord>(identifier, wParam, lParam); return ::DefWindowProcW(handle, message, wParam, lParam);
-		case WM_SYSKEYUP:
-			_publishKey<KeyReleasedRecord>(identifier, wParam, lParam); return ::DefWindowProcW(handle, message, wParam, lParam);
-		case WM_CHAR:
+		SPARKLE_PROFILE_SCOPE("PlatformRuntime::_inject");
+		const BaseEventRecord::Clock::time_point now = BaseEventRecord::Clock::now();
+		for (auto &record : records)
 		{
-			TextInputRecord record;
-			record.glyph = static_cast<wchar_t>(wParam);
-			_publish(identifier, std::move(record));
-			return 0;
-		}
-		default: return std::nullopt;
+			std::visit(
+				[now](BaseEventRecord &value) {
+					if (value.timestamp == BaseEventRecord::Clock::time_point())
+						value.timestamp = now;
+				},
+				record);
+			if (const auto *resize = std::get_if<WindowResizedRecord>(&record))
+			{
+				_renderRequestProducer.publish(SurfaceResizeRequest{
+					.windowHandle = resize->windowHandle,
+					.newSize = resize->size
+				});
+			}
 		}
+		_publishEvents(records);
 	}
 
-	LRESULT Application::PlatformRuntime::_processMessage(
-		const Identifier &identifier, HWND handle, UINT message, WPARAM wParam, LPARAM lParam)
+	void Application::PlatformRuntime::_consumeInjectedRecords()
 	{
-		if (auto result = _processWindowMessage(identifier, message, lParam))
-			return *result;
-		if (auto result = _processMouseMessage(identifier, handle, message, wParam, lParam))
-			return *result;
-		if (auto result = _processKeyboardMessage(identifier, handle, message, wParam, lParam))
-			return *result;
-		return ::DefWindowProcW(handle, message, wParam, lParam);
+		_inject(_injectedRecordConsumer.drain());
 	}
 
-	void Application::PlatformRuntime::_pullEvents() { WinAPI::MessageQueue::dispatchPending(); }
-	void Application::PlatformRuntime::consumeIncoming() { _consumeRequests(); }
-	void Application::PlatformRuntime::prepareCycle() { _pullEvents(); }
-
-	void Application::PlatformRuntime::tickOnce(const Window::Identifier &identifier, Window::Native &native)
+	void Application::PlatformRuntime::consumeIncoming()
 	{
-		native.frame().rethrowPendingException();
-		if (!native.frame().consumeClosureRequest())
-			return;
-		native.beginRelease();
-		_updateRequestProducer.publish(StateDeletionRequest{.windowIdentifier = identifier});
-		_renderRequestProducer.publish(SurfaceDeletionRequest{.windowIdentifier = identifier});
+		_consumeRequests();
+		_consumeInjectedRecords();
 	}
 
 	void Application::PlatformRuntime::release(Window::Native &native) { _destroyNative(native); }
@@ -0,0 +1,55 @@
+#include "internal/application_internal.hpp"
+
+#include <utility>
+
+namespace spk
+{
+	Application::PlatformRuntime::PlatformRuntime(
+		Platform::WakeEvent &wakeEvent,
+		PlatformRequestFIFO::Consumer platformRequestConsumer,
+		InjectedRecordFIFO::Consumer injectedRecordConsumer,
+		EventRecordProducer eventRecordProducer,
+		UpdateRequestProducer updateRequestProducer,
+		RenderRequestProducer renderRequestProducer) :
+		_wakeEvent(wakeEvent),
+		_platformRequestConsumer(std::move(platformRequestConsumer)),
+		_injectedRecordConsumer(std::move(injectedRecordConsumer)),
+		_eventRecordProducer(std::move(eventRecordProducer)),
+		_updateRequestProducer(std::move(updateRequestProducer)),
+		_renderRequestProducer(std::move(renderRequestProducer))
+	{
+	}
+
+	void Application::PlatformRuntime::_createNative(const NativeRegistrationRequest &request)
+	{
+		request.native->frame().create(Headless::Frame::CreationInfo{
+			.title = request.configuration.title,
+			.x = request.configuration.area.anchor.x,
+			.y = request.configuration.area.anchor.y,
+			.width = request.configuration.area.size.x,
+			.height = request.configuration.area.size.y});
+		request.native->markReady();
+
+		WindowResizedRecord record;
+		record.windowHandle = request.windowHandle;
+		record.timestamp = BaseEventRecord::Clock::now();
+		record.size = request.configuration.area.size;
+		_publishEvent(EventRecord(std::move(record)));
+	}
+
+	void Application::PlatformRuntime::_consume(const NativeDeletionRequest &request)
+	{
+		if (!contains(request.windowHandle))
+			return;
+		_destroyNative(object(request.windowHandle));
+		remove(request.windowHandle);
+	}
+
+	void Application::PlatformRuntime::prepareCycle() {}
+	void Application::PlatformRuntime::tickOnce(const Identifier &, Window::Native &, NativeEntry &) {}
+
+	void Application::PlatformRuntime::waitForActivity(std::stop_token)
+	{
+		_wakeEvent.wait();
+	}
+}
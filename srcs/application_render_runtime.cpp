@@ -1,36 +1,28 @@
 #include "internal/application_internal.hpp"
 
-#include <gl/gl.h>
-
 #include <utility>
 #include <variant>
 
+#include "render_backend.hpp"
 #include "render_context.hpp"
 
 namespace spk
 {
 	Application::RenderRuntime::RenderRuntime(
-		WinAPI::WakeEvent &wakeEvent,
-		spk::ThreadSafeFIFO<RenderRequest>::Consumer renderRequestConsumer,
-		spk::ThreadSafeFIFO<PlatformRequest>::Producer platformRequestProducer) :
-		_platformRequestProducer(std::move(platformRequestProducer), wakeEvent),
+		spk::WakeSignal &wakeSignal,
+		spk::WakeSignal &updaterWakeSignal,
+		spk::FramePacer &pacer,
+		Platform::WakeEvent &platformWakeEvent,
+		RenderRequestFIFO::Consumer renderRequestConsumer,
+		PlatformRequestFIFO::Producer platformRequestProducer) :
+		_wakeSignal(wakeSignal),
+		_updaterWakeSignal(updaterWakeSignal),
+		_pacer(pacer),
+		_platformRequestProducer(std::move(platformRequestProducer), platformWakeEvent),
 		_renderRequestConsumer(std::move(renderRequestConsumer))
 	{
 	}
 
-	void Application::RenderRuntime::_registerSnapshotConsumer(
-		const Window::Identifier &identifier,
-		spk::ThreadSafeSlot<spk::RenderSnapshot>::Consumer consumer,
-		std::shared_ptr<std::atomic_bool> isRequested)
-	{
-		isRequested->store(true, std::memory_order_relaxed);
-		auto [it, inserted] = _renderSnapshotEnties.emplace(identifier, RenderSnapshotEntry{std::move(consumer), std::move(isRequested)});
-		if (!inserted)
-		{
-			throw std::logic_error("A render snapshot consumer already exists for [" + identifier + "]");
-		}
-	}
-
 	void Application::RenderRuntime::_createSurface(Window::Surface &surface, const std::weak_ptr<Window::Native> &native)
 	{
 		const std::shared_ptr<Window::Native> lockedNative = native.lock();
@@ -46,32 +38,47 @@ namespace spk
 		surface.destroy();
 	}
 
-	void Application::RenderRuntime::_render(Window::Surface &surface, const spk::RenderSnapshot &snapshot)
+	bool Application::RenderRuntime::_render(Window::Surface &surface, const spk::RenderSnapshot &snapshot)
 	{
+		SPARKLE_PROFILE_SCOPE("RenderRuntime::_render");
 		const spk::Vector2UInt size = surface.geometry().size;
 		if (size.x == 0 || size.y == 0)
 		{
-			return;
+			return false;
 		}
 		surface.makeCurrent();
 
+		spk::RenderBackend &backend = surface.backend();
 		spk::RenderContext context{
-			.targetSurface = &surface};
+			.targetSurface = &surface,
+			.backend = &backend};
 
+		backend.beginFrame(size);
 		snapshot.execute(context);
+		backend.endFrame();
 
 		surface.present();
+		return true;
+	}
+
+	void Application::RenderRuntime::_recordPresentLatency(SurfaceEntry &entry, const spk::RenderSnapshot &snapshot)
+	{
+		const spk::RenderSnapshot::Clock::time_point now = spk::RenderSnapshot::Clock::now();
+		const spk::RenderSnapshot::Timestamps &timestamps = snapshot.timestamps();
+		entry.latency->snapshotToPresent.record(now - timestamps.build);
+		if (timestamps.input.has_value())
+			entry.latency->inputToPresent.record(now - *timestamps.input);
 	}
 
 	void Application::RenderRuntime::_consume(const SurfaceRegistrationRequest &request)
 	{
-		append(request.windowIdentifier, request.surface);
-		_registerSnapshotConsumer(request.windowIdentifier, request.renderSnapshotConsumer, request.isRequested);
+		request.isRequested->store(true, std::memory_order_relaxed);
+		append(request.windowHandle, request.surface, SurfaceEntry{.consumer = request.renderSnapshotConsumer, .isRequested = request.isRequested, .latency = request.latency});
 	}
 
 	void Application::RenderRuntime::_consume(const SurfaceCreationRequest &request)
 	{
-		Window::Surface *surface = tryGet(request.windowIdentifier);
+		Window::Surface *surface = tryGet(request.windowHandle);
 		if (surface != nullptr)
 		{
 			_createSurface(*surface, request.native);
@@ -80,7 +87,7 @@ namespace spk
 
 	void Application::RenderRuntime::_consume(const SurfaceResizeRequest &request)
 	{
-		Window::Surface *surface = tryGet(request.windowIdentifier);
+		Window::Surface *surface = tryGet(request.windowHandle);
 		if (surface == nullptr)
 		{
 			return;
@@ -96,14 +103,13 @@ namespace spk
 
 	void Application::RenderRuntime::_consume(const SurfaceDeletionRequest &request)
 	{
-		if (!contains(request.windowIdentifier))
+		if (!contains(request.windowHandle))
 		{
 			return;
 		}
-		_destroySurface(object(request.windowIdentifier));
-		remove(request.windowIdentifier);
-		_renderSnapshotEnties.erase(request.windowIdentifier);
-		_platformRequestProducer.publish(NativeDeletionRequest{.windowIdentifier = request.windowIdentifier});
+		_destroySurface(object(request.windowHandle));
+		remove(request.windowHandle);
+		_platformRequestProducer.publish(NativeDeletionRequest{.windowHandle = request.windowHandle});
 	}
 
 	void Application::RenderRuntime::_consumeRequests()
@@ -117,41 +123,80 @@ namespace spk
 		}
 	}
 
-	Application::RenderRuntime::RenderSnapshotEntry *Application::RenderRuntime::_tryGetSnapshotConsumer(
-		const Window::Identifier &identifier)
+	void Application::RenderRuntime::consumeIncoming()
 	{
-		auto it = _renderSnapshotEnties.find(identifier);
-		return it != _renderSnapshotEnties.end() ? &it->second : nullptr;
+		_consumeRequests();
 	}
 
-	void Application::RenderRuntime::consumeIncoming()
+	void Application::RenderRuntime::prepareCycle()
 	{
-		_consumeRequests();
+		_isRenderDue = _pacer.isRenderDue(spk::FramePacer::Clock::now());
+		_hasRendered = false;
+		_hasDeferredFrame = false;
 	}
 
-	void Application::RenderRuntime::tickOnce(const Window::Identifier &identifier, Window::Surface &surface)
+	void Application::RenderRuntime::_presentPendingSnapshot(Window::Surface &surface, SurfaceEntry &entry)
+	{
+		const spk::RenderSnapshot *snapshot = entry.consumer.latest();
+		const spk::Vector2UInt size = surface.geometry().size;
+		const bool isUnchanged = entry.lastRenderedRevision == snapshot->revision() &&
+								 entry.lastRenderedSize == size;
+		if (!isUnchanged)
+		{
+			if (!_isRenderDue)
+			{
+				_hasDeferredFrame = true;
+				return;
+			}
+			entry.lastRenderedSize = size;
+			if (_render(surface, *snapshot))
+			{
+				_hasRendered = true;
+				if (entry.lastRenderedRevision != snapshot->revision())
+					_recordPresentLatency(entry, *snapshot);
+			}
+		}
+		entry.hasPendingSnapshot = false;
+		entry.lastRenderedRevision = snapshot->revision();
+		entry.isRequested->store(true, std::memory_order_release);
+		_updaterWakeSignal.notify();
+	}
+
+	void Application::RenderRuntime::tickOnce(const Identifier &, Window::Surface &surface, SurfaceEntry &entry)
 	{
 		if (surface.lifeCycle() != Window::LifeCycle::Ready)
 		{
 			return;
 		}
 
-		auto *entry = _tryGetSnapshotConsumer(identifier);
-		if (entry == nullptr)
+		if (entry.consumer.update())
 		{
-			return;
+			entry.hasPendingSnapshot = true;
 		}
 
-		auto snapshot = entry->consumer.acquireLatest();
-		if (snapshot != nullptr && snapshot != entry->lastRenderedSnapshot)
+		if (entry.hasPendingSnapshot)
 		{
-			entry->lastRenderedSnapshot = snapshot;
-			_render(surface, *snapshot);
-			entry->isRequested->store(true, std::memory_order_relaxed);
+			_presentPendingSnapshot(surface, entry);
 		}
+		// Reclaimed even while frames are deferred, so released resources do not pile up until the next render.
 		surface._gpuResources().reclaimReleased();
 	}
 
+	void Application::RenderRuntime::finishCycle()
+	{
+		if (_hasRendered)
+			_pacer.markRendered(spk::FramePacer::Clock::now());
+	}
+
+	void Application::RenderRuntime::waitForActivity(std::stop_token stopToken)
+	{
+		const auto deadline = _hasDeferredFrame ? _pacer.nextRenderDeadline() : std::nullopt;
+		if (deadline.has_value())
+			_wakeSignal.waitUntil(*deadline, stopToken);
+		else
+			_wakeSignal.wait(stopToken);
+	}
+
 	void Application::RenderRuntime::release(Window::Surface &surface)
 	{
 		_destroySurface(surface);
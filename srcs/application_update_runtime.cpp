@@ -1,6 +1,7 @@
 #include "internal/application_internal.hpp"
 
 #include <cstdint>
+#include <span>
 #include <utility>
 #include <variant>
 
@@ -14,24 +15,30 @@
 namespace spk
 {
 	Application::UpdateRuntime::UpdateRuntime(
-		spk::ThreadSafeFIFO<EventRecord>::Consumer eventRecordConsumer,
-		spk::ThreadSafeFIFO<UpdateRequest>::Consumer updateRequestConsumer) :
+		spk::WakeSignal &wakeSignal,
+		spk::WakeSignal &rendererWakeSignal,
+		spk::FramePacer &pacer,
+		EventRecordFIFO::Consumer eventRecordConsumer,
+		UpdateRequestFIFO::Consumer updateRequestConsumer,
+		spk::JobSystem &jobSystem,
+		bool isSnapshotBuildParallel,
+		std::size_t snapshotBuildGranularity,
+		bool isWindowUpdateParallel) :
+		_wakeSignal(wakeSignal),
+		_rendererWakeSignal(rendererWakeSignal),
+		_pacer(pacer),
+		_jobSystem(jobSystem),
+		_taskScheduler(
+			wakeSignal,
+			std::chrono::duration_cast<spk::TaskScheduler::Clock::duration>(std::chrono::duration<double>(1.0 / pacer.configuration().updateRate))),
 		_eventRecordConsumer(std::move(eventRecordConsumer)),
 		_updateRequestConsumer(std::move(updateRequestConsumer)),
-		_startTime(std::chrono::steady_clock::now()), _currentTime(_startTime)
+		_isSnapshotBuildParallel(isSnapshotBuildParallel),
+		_snapshotBuildGranularity(snapshotBuildGranularity),
+		_isWindowUpdateParallel(isWindowUpdateParallel)
 	{
 	}
 
-	void Application::UpdateRuntime::_registerSnapshotProducer(
-		const Window::Identifier &identifier,
-		spk::ThreadSafeSlot<spk::RenderSnapshot>::Producer producer,
-		std::shared_ptr<std::atomic_bool> isRequested)
-	{
-		auto [it, inserted] = _renderSnapshotEntries.emplace(identifier, RenderSnapshotEntry{std::move(producer), std::move(isRequested)});
-		if (!inserted)
-			throw std::logic_error("A render snapshot producer already exists for [" + identifier + "]");
-	}
-
 	template <typename TEvent>
 	void Application::UpdateRuntime::_applyFocusChanges(const TEvent &event, Window::State &state)
 	{
@@ -48,18 +55,41 @@ namespace spk
 		}
 	}
 
+	template <typename TRecord>
+	void Application::UpdateRuntime::_trackDispatch(std::span<const TRecord> records)
+	{
+		StateEntry *entry = records.empty() ? nullptr : tryGetEntry(records.front().windowHandle);
+		if (entry == nullptr)
+			return;
+
+		const spk::RenderSnapshot::Clock::time_point now = spk::RenderSnapshot::Clock::now();
+		for (const TRecord &record : records)
+		{
+			if (record.timestamp == BaseEventRecord::Clock::time_point())
+				continue;
+			entry->latency->inputToDispatch.record(now - record.timestamp);
+			if (!entry->pendingInputTimestamp.has_value() || *entry->pendingInputTimestamp < record.timestamp)
+			{
+				entry->pendingInputTimestamp = record.timestamp;
+				entry->pendingInputDispatchTimestamp = now;
+			}
+		}
+	}
+
 	template <typename TRecord>
 	void Application::UpdateRuntime::_dispatch(const TRecord &record, Window::State &state)
 	{
+		_trackDispatch(std::span<const TRecord>(&record, 1));
 		Event<TRecord> event(record);
 		state.root().dispatch(event);
 		_applyFocusChanges(event, state);
 	}
 
 	template <typename TRecord>
-	void Application::UpdateRuntime::_dispatchMouse(const TRecord &record, Window::State &state)
+	void Application::UpdateRuntime::_dispatchMouse(const TRecord &record, std::span<const TRecord> history, Window::State &state)
 	{
-		DeviceEvent<TRecord, spk::Mouse> event(record, state.mouse());
+		_trackDispatch(history);
+		DeviceEvent<TRecord, spk::Mouse> event(record, history, state.mouse());
 		state.dispatchRoot(FocusMode::Channel::Mouse).dispatch(event);
 		_applyFocusChanges(event, state);
 	}
@@ -67,6 +97,7 @@ namespace spk
 	template <typename TRecord>
 	void Application::UpdateRuntime::_dispatchKeyboard(const TRecord &record, Window::State &state)
 	{
+		_trackDispatch(std::span<const TRecord>(&record, 1));
 		DeviceEvent<TRecord, spk::Keyboard> event(record, state.keyboard());
 		state.dispatchRoot(FocusMode::Channel::Keyboard).dispatch(event);
 		_applyFocusChanges(event, state);
@@ -75,7 +106,7 @@ namespace spk
 	template <typename TRecord>
 	Window::State *Application::UpdateRuntime::_state(const TRecord &record)
 	{
-		return tryGet(record.windowIdentifier);
+		return tryGet(record.windowHandle);
 	}
 
 	void Application::UpdateRuntime::_consume(const WindowResizedRecord &record)
@@ -130,6 +161,11 @@ namespace spk
 	}
 
 	void Application::UpdateRuntime::_consume(const MouseMovedRecord &record)
+	{
+		_consume(record, {&record, 1});
+	}
+
+	void Application::UpdateRuntime::_consume(const MouseMovedRecord &record, std::span<const MouseMovedRecord> history)
 	{
 		Window::State *state = _state(record);
 		if (state == nullptr)
@@ -143,16 +179,21 @@ namespace spk
 		}
 		mouse.deltaPosition = delta;
 		mouse.position = record.position;
-		_dispatchMouse(record, *state);
+		_dispatchMouse(record, history, *state);
 	}
 
 	void Application::UpdateRuntime::_consume(const MouseWheelScrolledRecord &record)
+	{
+		_consume(record, {&record, 1});
+	}
+
+	void Application::UpdateRuntime::_consume(const MouseWheelScrolledRecord &record, std::span<const MouseWheelScrolledRecord> history)
 	{
 		Window::State *state = _state(record);
 		if (state == nullptr)
 			return;
 		state->mouse().wheel += record.value.y;
-		_dispatchMouse(record, *state);
+		_dispatchMouse(record, history, *state);
 	}
 
 	void Application::UpdateRuntime::_consume(const MouseButtonPressedRecord &record)
@@ -161,7 +202,7 @@ namespace spk
 		if (state == nullptr)
 			return;
 		state->mouse()[record.button] = spk::InputState::Down;
-		_dispatchMouse(record, *state);
+		_dispatchMouse(record, {&record, 1}, *state);
 	}
 
 	void Application::UpdateRuntime::_consume(const MouseButtonReleasedRecord &record)
@@ -170,7 +211,7 @@ namespace spk
 		if (state == nullptr)
 			return;
 		state->mouse()[record.button] = spk::InputState::Up;
-		_dispatchMouse(record, *state);
+		_dispatchMouse(record, {&record, 1}, *state);
 	}
 
 	void Application::UpdateRuntime::_consume(const MouseButtonDoubleClickedRecord &record)
@@ -179,7 +220,7 @@ namespace spk
 		if (state == nullptr)
 			return;
 		state->mouse()[record.button] = spk::InputState::Down;
-		_dispatchMouse(record, *state);
+		_dispatchMouse(record, {&record, 1}, *state);
 	}
 
 	void Application::UpdateRuntime::_consume(const KeyPressedRecord &record)
@@ -216,86 +257,222 @@ namespace spk
 
 	void Application::UpdateRuntime::_consume(const StateRegistrationRequest &request)
 	{
-		append(request.windowIdentifier, request.state);
+		append(request.windowHandle, request.state, StateEntry{.producer = request.renderSnapshotProducer, .isRequested = request.isRequested, .latency = request.latency});
 		request.state->setBackgroundColor(request.backgroundColor);
-		_registerSnapshotProducer(request.windowIdentifier, request.renderSnapshotProducer, request.isRequested);
 		request.state->markReady();
 	}
 
 	void Application::UpdateRuntime::_consume(const StateDeletionRequest &request)
 	{
-		if (!contains(request.windowIdentifier))
+		if (!contains(request.windowHandle))
 			return;
-		auto &state = object(request.windowIdentifier);
+		auto &state = object(request.windowHandle);
 		release(state);
-		_renderSnapshotEntries.erase(request.windowIdentifier);
-		remove(request.windowIdentifier);
+		remove(request.windowHandle);
+	}
+
+	std::size_t Application::UpdateRuntime::_coalescedRunEnd(const EventRecordFIFO::container_type &events, std::size_t first)
+	{
+		const EventRecord &head = events[first];
+		if (!std::holds_alternative<MouseMovedRecord>(head) && !std::holds_alternative<MouseWheelScrolledRecord>(head))
+			return first + 1;
+
+		const Identifier &identifier = std::visit([](const auto &record) -> const Identifier & { return record.windowHandle; }, head);
+		std::size_t last = first + 1;
+		while (last < events.size() &&
+			   events[last].index() == head.index() &&
+			   std::visit([](const auto &record) -> const Identifier & { return record.windowHandle; }, events[last]) == identifier)
+		{
+			++last;
+		}
+		return last;
+	}
+
+	template <typename TRecord>
+	std::span<const TRecord> Application::UpdateRuntime::_collectHistory(std::span<EventRecord> events, std::vector<TRecord> &history)
+	{
+		history.clear();
+		for (EventRecord &event : events)
+			history.push_back(std::move(std::get<TRecord>(event)));
+		return history;
+	}
+
+	void Application::UpdateRuntime::_consumeCoalesced(std::span<EventRecord> events)
+	{
+		if (std::holds_alternative<MouseMovedRecord>(events.front()))
+		{
+			const auto history = _collectHistory(events, _mouseMovedHistory);
+			_consume(history.back(), history);
+			return;
+		}
+
+		const auto history = _collectHistory(events, _mouseWheelScrolledHistory);
+		MouseWheelScrolledRecord merged = history.back();
+		merged.value = {};
+		for (const MouseWheelScrolledRecord &record : history)
+			merged.value += record.value;
+		_consume(merged, history);
 	}
 
-	void Application::UpdateRuntime::_consumeEvents()
+	bool Application::UpdateRuntime::_consumeEvents()
 	{
-		for (auto &event : _eventRecordConsumer.drain())
-			_consume(event);
+		SPARKLE_PROFILE_SCOPE("UpdateRuntime::_consumeEvents");
+		// Consecutive moves or wheel scrolls aimed at the same window are dispatched once per drain; any other record
+		// ends the run, so button and key events still observe the pointer exactly where the platform reported it.
+		auto &events = _eventRecordConsumer.drain();
+		for (std::size_t first = 0; first < events.size();)
+		{
+			const std::size_t last = _coalescedRunEnd(events, first);
+			if (last - first == 1)
+				_consume(events[first]);
+			else
+				_consumeCoalesced(std::span(events).subspan(first, last - first));
+			first = last;
+		}
+		return !events.empty();
 	}
 
-	void Application::UpdateRuntime::_consumeRequests()
+	bool Application::UpdateRuntime::_consumeRequests()
 	{
-		for (auto &request : _updateRequestConsumer.drain())
+		auto &requests = _updateRequestConsumer.drain();
+		for (auto &request : requests)
 			std::visit([this](const auto &value) { _consume(value); }, request);
+		return !requests.empty();
 	}
 
 	void Application::UpdateRuntime::_updateState(Window::State &state, UpdateContext &context)
 	{
+		SPARKLE_PROFILE_SCOPE("UpdateRuntime::_updateState");
 		state.root().updateState(context);
 	}
 
-	spk::RenderSnapshot Application::UpdateRuntime::_buildRenderSnapshot(Window::State &state)
+	void Application::UpdateRuntime::_buildRenderSnapshot(StateEntry &entry, Window::State &state)
 	{
-		spk::RenderSnapshot::Builder builder;
+		SPARKLE_PROFILE_SCOPE("UpdateRuntime::_buildRenderSnapshot");
+		spk::RenderSnapshot::Builder builder(entry.commandPool, entry.fragmentPool);
+		builder.setJobSystem(_isSnapshotBuildParallel ? &_jobSystem : nullptr, _snapshotBuildGranularity);
 		state.root().buildRenderSnapshot(builder);
-		return builder.build();
+		builder.build(entry.producer.back(), state.renderRevision());
 	}
 
-	bool Application::UpdateRuntime::_consumeSnapshotRequest(const Window::Identifier &identifier)
+	bool Application::UpdateRuntime::_consumeSnapshotRequest(StateEntry &entry)
 	{
-		return _renderSnapshotEntries.at(identifier).isRequested->exchange(false, std::memory_order_acq_rel);
+		return entry.isRequested->exchange(false, std::memory_order_acq_rel);
 	}
 
-	void Application::UpdateRuntime::_publishSnapshot(const Window::Identifier &identifier, spk::RenderSnapshot &&snapshot)
+	void Application::UpdateRuntime::_stampSnapshot(StateEntry &entry)
 	{
-		_renderSnapshotEntries.at(identifier).producer.publish(std::move(snapshot));
+		const spk::RenderSnapshot::Clock::time_point now = spk::RenderSnapshot::Clock::now();
+		entry.producer.back().setTimestamps({.input = entry.pendingInputTimestamp, .build = now});
+		if (entry.pendingInputTimestamp.has_value())
+		{
+			entry.latency->dispatchToSnapshot.record(now - entry.pendingInputDispatchTimestamp);
+			entry.pendingInputTimestamp.reset();
+		}
+	}
+
+	void Application::UpdateRuntime::_publishSnapshot(StateEntry &entry)
+	{
+		entry.publishedRevision = entry.producer.back().revision();
+		entry.producer.publish();
+		_rendererWakeSignal.notify();
 	}
 
 	void Application::UpdateRuntime::consumeIncoming()
 	{
-		_consumeRequests();
-		_consumeEvents();
+		const bool hasConsumedRequests = _consumeRequests();
+		const bool hasConsumedEvents = _consumeEvents();
+		_hasConsumedInput = hasConsumedRequests || hasConsumedEvents;
 	}
 
 	void Application::UpdateRuntime::prepareCycle()
 	{
-		_currentTime = std::chrono::steady_clock::now();
-		_deltaTime = _lastTime.has_value() ? _currentTime - *_lastTime : std::chrono::steady_clock::duration::zero();
+		const spk::FramePacer::Clock::time_point now = spk::FramePacer::Clock::now();
+		_taskScheduler.resumeReady(now);
+		_cycle = _pacer.beginUpdate(now, _hasConsumedInput);
 	}
 
-	void Application::UpdateRuntime::tickOnce(const Window::Identifier &identifier, Window::State &state)
+	void Application::UpdateRuntime::tickOnce(const Identifier &, Window::State &state, StateEntry &entry)
 	{
-		UpdateContext context{
-			.time = _currentTime - _startTime,
-			.deltaTime = _deltaTime,
-			.keyboard = state.keyboard(),
-			.mouse = state.mouse()};
-		_updateState(state, context);
-		
-		if (_consumeSnapshotRequest(identifier))
-		{			
-			_publishSnapshot(identifier, _buildRenderSnapshot(state));
+		const Window::UpdateStatistics::Clock::time_point startTime = Window::UpdateStatistics::Clock::now();
+		bool hasWorked = _cycle.stepCount != 0;
+
+		for (std::size_t step = 0; step < _cycle.stepCount; ++step)
+		{
+			UpdateContext context{
+				.time = _cycle.startTime + _cycle.deltaTime * static_cast<spk::FramePacer::Clock::rep>(step + 1),
+				.deltaTime = _cycle.deltaTime,
+				.alpha = _cycle.alpha,
+				.keyboard = state.keyboard(),
+				.mouse = state.mouse(),
+				.jobs = _jobSystem,
+				.tasks = _taskScheduler};
+			_updateState(state, context);
+		}
+
+		const bool isOutdated = !entry.publishedRevision.has_value() || *entry.publishedRevision != state.renderRevision();
+		if (isOutdated && _consumeSnapshotRequest(entry))
+		{
+			_buildRenderSnapshot(entry, state);
+			_stampSnapshot(entry);
+			_publishSnapshot(entry);
+			hasWorked = true;
+		}
+		else if (!isOutdated && _cycle.stepCount != 0)
+		{
+			// The inputs were dispatched and updated without changing what is drawn: no snapshot will ever reflect them.
+			entry.pendingInputTimestamp.reset();
 		}
+
+		if (hasWorked)
+		{
+			state.recordUpdate(Window::UpdateStatistics::Clock::now() - startTime);
+		}
+	}
+
+	void Application::UpdateRuntime::tickAll()
+	{
+		Collection &collection = registrations();
+		if (!_isWindowUpdateParallel || collection.size() < 2)
+		{
+			Runtime::tickAll();
+			return;
+		}
+
+		// Windows share no state during a tick: each one owns its widget tree, its pools and its snapshot buffer, and
+		// the cycle is only read. The loop joins before returning, so finishCycle still sees every window updated.
+		_jobSystem.parallelFor(
+			collection.size(),
+			[this, &collection](std::size_t begin, std::size_t end) {
+				for (std::size_t index = begin; index < end; ++index)
+				{
+					auto &[identifier, registration] = *(collection.begin() + static_cast<std::ptrdiff_t>(index));
+					tickOnce(identifier, *registration.object, registration.entry);
+				}
+			},
+			1);
+	}
+
+	void Application::UpdateRuntime::waitForActivity(std::stop_token stopToken)
+	{
+		auto deadline = _pacer.nextUpdateDeadline();
+		const auto taskDeadline = _taskScheduler.nextDeadline(spk::FramePacer::Clock::now());
+		if (taskDeadline.has_value() && (!deadline.has_value() || *taskDeadline < *deadline))
+			deadline = taskDeadline;
+		if (deadline.has_value())
+			_wakeSignal.waitUntil(*deadline, stopToken);
+		else
+			_wakeSignal.wait(stopToken);
+	}
+
+	void Application::UpdateRuntime::closeEventChannel()
+	{
+		_eventRecordConsumer.close();
 	}
 
-	void Application::UpdateRuntime::finishCycle()
+	Application::EventChannelStatistics Application::UpdateRuntime::eventChannelStatistics() const
 	{
-		_lastTime = _currentTime;
+		return _eventRecordConsumer.statistics();
 	}
 
 	void Application::UpdateRuntime::release(Window::State &state)
@@ -1,7 +1,7 @@
 #include "clear_render_command.hpp"
 
-#include <Windows.h>
-#include <gl/gl.h>
+#include "render_backend.hpp"
+#include "render_context.hpp"
 
 namespace spk
 {
@@ -11,23 +11,8 @@ namespace spk
 	{
 	}
 
-	void ClearRenderCommand::execute(RenderContext &) const
+	void ClearRenderCommand::execute(RenderContext &renderContext) const
 	{
-		GLbitfield mask = 0;
-
-		if ((_mask & Mask::Color) != Mask::None)
-			mask |= GL_COLOR_BUFFER_BIT;
-
-		if ((_mask & Mask::Depth) != Mask::None)
-			mask |= GL_DEPTH_BUFFER_BIT;
-
-		if ((_mask & Mask::Stencil) != Mask::None)
-			mask |= GL_STENCIL_BUFFER_BIT;
-
-		if ((_mask & Mask::Color) != Mask::None)
-			::glClearColor(_color.r, _color.g, _color.b, _color.a);
-
-		if (mask != 0)
-			::glClear(mask);
+		renderContext.backend->clear(_color, _mask);
 	}
-}
\ No newline at end of file
+}
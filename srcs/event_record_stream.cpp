@@ -0,0 +1,284 @@
+#include "event_record_stream.hpp"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "application.hpp"
+
+namespace spk
+{
+	namespace
+	{
+		constexpr std::array<char, 4> Magic = {'S', 'P', 'K', 'R'};
+		constexpr std::uint8_t Version = 1;
+
+		class Output
+		{
+		private:
+			std::ostream &_stream;
+
+		public:
+			explicit Output(std::ostream &stream) :
+				_stream(stream)
+			{
+			}
+
+			void bytes(const void *data, std::size_t size)
+			{
+				_stream.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+			}
+
+			void varint(std::uint64_t value)
+			{
+				while (value >= 0x80)
+				{
+					const auto byte = static_cast<std::uint8_t>(value | 0x80);
+					bytes(&byte, 1);
+					value >>= 7;
+				}
+				const auto byte = static_cast<std::uint8_t>(value);
+				bytes(&byte, 1);
+			}
+
+			template <typename TValue>
+			void operator()(const TValue &value)
+			{
+				if constexpr (std::is_arithmetic_v<TValue> || std::is_enum_v<TValue>)
+				{
+					bytes(&value, sizeof(value));
+				}
+				else
+				{
+					(*this)(value.x);
+					(*this)(value.y);
+				}
+			}
+		};
+
+		class Input
+		{
+		private:
+			std::istream &_stream;
+
+		public:
+			explicit Input(std::istream &stream) :
+				_stream(stream)
+			{
+			}
+
+			void bytes(void *data, std::size_t size)
+			{
+				if (!_stream.read(static_cast<char *>(data), static_cast<std::streamsize>(size)))
+					throw std::runtime_error("EventRecord stream ended in the middle of a record");
+			}
+
+			[[nodiscard]] std::uint64_t varint()
+			{
+				std::uint64_t result = 0;
+				for (unsigned shift = 0; shift < 64; shift += 7)
+				{
+					std::uint8_t byte = 0;
+					bytes(&byte, 1);
+					result |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+					if ((byte & 0x80) == 0)
+						return result;
+				}
+				throw std::runtime_error("EventRecord stream contains an oversized varint");
+			}
+
+			template <typename TValue>
+			void operator()(TValue &value)
+			{
+				if constexpr (std::is_arithmetic_v<TValue> || std::is_enum_v<TValue>)
+				{
+					bytes(&value, sizeof(value));
+				}
+				else
+				{
+					(*this)(value.x);
+					(*this)(value.y);
+				}
+			}
+		};
+
+		[[nodiscard]] std::uint64_t zigzag(std::int64_t value) noexcept
+		{
+			return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+		}
+
+		[[nodiscard]] std::int64_t unzigzag(std::uint64_t value) noexcept
+		{
+			return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+		}
+
+		template <typename TArchive, typename TRecord>
+		void visitPayload(TArchive &archive, TRecord &record)
+		{
+			using Type = std::remove_const_t<TRecord>;
+			if constexpr (std::is_same_v<Type, WindowResizedRecord>)
+				archive(record.size);
+			else if constexpr (std::is_same_v<Type, MouseMovedRecord>)
+				archive(record.position);
+			else if constexpr (std::is_same_v<Type, MouseWheelScrolledRecord>)
+				archive(record.value);
+			else if constexpr (requires { record.button; })
+				archive(record.button);
+			else if constexpr (requires { record.key; })
+				archive(record.key);
+			else if constexpr (std::is_same_v<Type, TextInputRecord>)
+				archive(record.glyph);
+		}
+
+		template <std::size_t... TIndexes>
+		[[nodiscard]] EventRecord emplaceAlternative(std::size_t index, std::index_sequence<TIndexes...>)
+		{
+			EventRecord result;
+			const bool isKnown = ((index == TIndexes ? (result.emplace<TIndexes>(), true) : false) || ...);
+			if (!isKnown)
+				throw std::runtime_error("EventRecord stream contains an unknown record type");
+			return result;
+		}
+	}
+
+	EventRecordWriter::EventRecordWriter(std::ostream &stream) :
+		_stream(stream)
+	{
+		Output output(_stream);
+		output.bytes(Magic.data(), Magic.size());
+		output(Version);
+	}
+
+	void EventRecordWriter::_write(const EventRecord &record)
+	{
+		Output output(_stream);
+		output(static_cast<std::uint8_t>(record.index()));
+		std::visit(
+			[&](const auto &value) {
+				output.varint(value.windowHandle.index);
+				output.varint(value.windowHandle.generation);
+				output.varint(zigzag((value.timestamp - _previousTimestamp).count()));
+				_previousTimestamp = value.timestamp;
+				visitPayload(output, value);
+			},
+			record);
+		++_recordCount;
+	}
+
+	void EventRecordWriter::write(const EventRecord &record)
+	{
+		const std::scoped_lock lock(_mutex);
+		_write(record);
+	}
+
+	void EventRecordWriter::write(std::span<const EventRecord> records)
+	{
+		const std::scoped_lock lock(_mutex);
+		for (const EventRecord &record : records)
+			_write(record);
+	}
+
+	void EventRecordWriter::flush()
+	{
+		const std::scoped_lock lock(_mutex);
+		_stream.flush();
+	}
+
+	std::uint64_t EventRecordWriter::recordCount() const
+	{
+		const std::scoped_lock lock(_mutex);
+		return _recordCount;
+	}
+
+	EventRecordReader::EventRecordReader(std::istream &stream) :
+		_stream(stream)
+	{
+		Input input(_stream);
+		std::array<char, Magic.size()> magic{};
+		std::uint8_t version = 0;
+		input.bytes(magic.data(), magic.size());
+		input(version);
+		if (magic != Magic || version != Version)
+			throw std::runtime_error("Not a supported EventRecord stream");
+	}
+
+	std::optional<EventRecord> EventRecordReader::read()
+	{
+		if (_stream.peek() == std::istream::traits_type::eof())
+			return std::nullopt;
+
+		Input input(_stream);
+		std::uint8_t type = 0;
+		input(type);
+		EventRecord result = emplaceAlternative(type, std::make_index_sequence<std::variant_size_v<EventRecord>>());
+		std::visit(
+			[&](auto &value) {
+				value.windowHandle.index = static_cast<std::uint32_t>(input.varint());
+				value.windowHandle.generation = static_cast<std::uint32_t>(input.varint());
+				_previousTimestamp += BaseEventRecord::Clock::duration(unzigzag(input.varint()));
+				value.timestamp = _previousTimestamp;
+				visitPayload(input, value);
+			},
+			result);
+		return result;
+	}
+
+	std::uint64_t EventRecordReplayer::replay(Application &application, EventRecordReader &reader, Speed speed, std::stop_token stopToken)
+	{
+		using Clock = BaseEventRecord::Clock;
+
+		std::uint64_t injectedCount = 0;
+		std::vector<EventRecord> batch;
+		const Clock::time_point replayStart = Clock::now();
+		std::optional<Clock::time_point> recordingStart;
+		// Nothing ever notifies the condition: it only gives the wait between records a stop token to return on.
+		std::mutex waitMutex;
+		std::condition_variable_any waitCondition;
+
+		const auto flush = [&] {
+			injectedCount += batch.size();
+			application.inject(std::exchange(batch, {}));
+		};
+
+		while (!stopToken.stop_requested())
+		{
+			std::optional<EventRecord> record = reader.read();
+			if (!record.has_value())
+				break;
+
+			Clock::time_point replayTime = Clock::now();
+			if (speed == Speed::Original)
+			{
+				const Clock::time_point recordedTime = std::visit([](const auto &value) { return value.timestamp; }, *record);
+				if (!recordingStart.has_value())
+					recordingStart = recordedTime;
+				replayTime = replayStart + (recordedTime - *recordingStart);
+				if (replayTime > Clock::now())
+				{
+					// Records due at the same time are injected together, as the platform would have published them.
+					if (!batch.empty())
+						flush();
+					std::unique_lock lock(waitMutex);
+					static_cast<void>(waitCondition.wait_until(lock, stopToken, replayTime, [] { return false; }));
+					if (stopToken.stop_requested())
+						break;
+				}
+			}
+
+			std::visit([replayTime](auto &value) { value.timestamp = replayTime; }, *record);
+			batch.push_back(std::move(*record));
+			if (batch.size() == BatchSize)
+				flush();
+		}
+
+		if (!batch.empty())
+			flush();
+		return injectedCount;
+	}
+}
@@ -0,0 +1,126 @@
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace spk
+{
+	FramePacer::FramePacer() :
+		FramePacer(Configuration{})
+	{
+	}
+
+	FramePacer::FramePacer(const Configuration &configuration) :
+		_configuration(configuration),
+		_updatePeriod(_period(configuration.updateRate))
+	{
+		if (configuration.maxCatchUpSteps == 0)
+			throw std::invalid_argument("FramePacer requires at least one catch-up step per cycle");
+		if (configuration.renderRate.has_value())
+			_renderPeriod = _period(*configuration.renderRate);
+	}
+
+	FramePacer::Clock::duration FramePacer::_period(double rate)
+	{
+		if (!(rate > 0.0))
+			throw std::invalid_argument("FramePacer rates must be strictly positive");
+		return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+	}
+
+	const FramePacer::Configuration &FramePacer::configuration() const noexcept
+	{
+		return _configuration;
+	}
+
+	FramePacer::UpdateCycle FramePacer::_beginFixedStep(Clock::time_point now)
+	{
+		if (!_lastUpdateTime.has_value())
+		{
+			_lastUpdateTime = now;
+			_nextUpdateTime = now + _updatePeriod;
+			return UpdateCycle{.startTime = _simulatedTime, .deltaTime = _updatePeriod};
+		}
+
+		_accumulator += now - *_lastUpdateTime;
+		_lastUpdateTime = now;
+		_accumulator = std::min(_accumulator, _updatePeriod * static_cast<Clock::rep>(_configuration.maxCatchUpSteps));
+
+		const auto stepCount = static_cast<std::size_t>(_accumulator / _updatePeriod);
+		const Clock::duration startTime = _simulatedTime;
+		_accumulator -= _updatePeriod * static_cast<Clock::rep>(stepCount);
+		_simulatedTime += _updatePeriod * static_cast<Clock::rep>(stepCount);
+		_nextUpdateTime = now + (_updatePeriod - _accumulator);
+
+		return UpdateCycle{
+			.stepCount = stepCount,
+			.startTime = startTime,
+			.deltaTime = _updatePeriod,
+			.alpha = std::chrono::duration<float>(_accumulator) / std::chrono::duration<float>(_updatePeriod)};
+	}
+
+	FramePacer::UpdateCycle FramePacer::_beginVariableStep(Clock::time_point now, std::size_t stepCount)
+	{
+		if (stepCount == 0)
+			return UpdateCycle{.startTime = _simulatedTime};
+
+		const Clock::duration deltaTime = _lastUpdateTime.has_value() ? now - *_lastUpdateTime : Clock::duration::zero();
+		const UpdateCycle result{
+			.stepCount = 1,
+			.startTime = _simulatedTime,
+			.deltaTime = deltaTime,
+			.alpha = 1.0f};
+
+		_lastUpdateTime = now;
+		_simulatedTime += deltaTime;
+		return result;
+	}
+
+	FramePacer::UpdateCycle FramePacer::beginUpdate(Clock::time_point now, bool hasPendingInput)
+	{
+		switch (_configuration.mode)
+		{
+		case Mode::FixedStep:
+			return _beginFixedStep(now);
+		case Mode::OnDemand:
+			_nextUpdateTime.reset();
+			return _beginVariableStep(now, hasPendingInput ? 1 : 0);
+		case Mode::Unlimited:
+			_nextUpdateTime = now;
+			return _beginVariableStep(now, 1);
+		}
+		return UpdateCycle{};
+	}
+
+	std::optional<FramePacer::Clock::time_point> FramePacer::nextUpdateDeadline() const noexcept
+	{
+		return _nextUpdateTime;
+	}
+
+	bool FramePacer::isRenderDue(Clock::time_point now) const noexcept
+	{
+		if (!_renderPeriod.has_value() || _configuration.mode == Mode::Unlimited || !_nextRenderTime.has_value())
+			return true;
+		return now >= *_nextRenderTime;
+	}
+
+	void FramePacer::markRendered(Clock::time_point now) noexcept
+	{
+		if (!_renderPeriod.has_value() || _configuration.mode == Mode::Unlimited)
+			return;
+
+		if (!_nextRenderTime.has_value() || now - *_nextRenderTime >= *_renderPeriod)
+		{
+			_nextRenderTime = now + *_renderPeriod;
+			return;
+		}
+		while (*_nextRenderTime <= now)
+			*_nextRenderTime += *_renderPeriod;
+	}
+
+	std::optional<FramePacer::Clock::time_point> FramePacer::nextRenderDeadline() const noexcept
+	{
+		if (!_renderPeriod.has_value() || _configuration.mode == Mode::Unlimited)
+			return std::nullopt;
+		return _nextRenderTime;
+	}
+}
@@ -0,0 +1,39 @@
+#include "headless_frame.hpp"
+
+#include <stdexcept>
+
+namespace spk::Headless
+{
+	void Frame::create(const CreationInfo &info)
+	{
+		if (_isCreated)
+			throw std::logic_error("The headless frame is already created");
+		_title = info.title;
+		_geometry = spk::Rect2D{
+			.anchor = {info.x, info.y},
+			.size = {info.width, info.height}};
+		_isCreated = true;
+	}
+
+	void Frame::destroy() noexcept
+	{
+		_isCreated = false;
+	}
+
+	bool Frame::isCreated() const noexcept
+	{
+		return _isCreated;
+	}
+
+	const std::string &Frame::title() const noexcept
+	{
+		return _title;
+	}
+
+	spk::Rect2D Frame::geometry() const
+	{
+		if (!_isCreated)
+			throw std::logic_error("Cannot retrieve the geometry of an uninitialized headless frame");
+		return _geometry;
+	}
+}
@@ -2,84 +2,160 @@
 
 #include "application.hpp"
 
+#include "platform.hpp"
+
+#if defined(SPARKLE_PLATFORM_WINAPI)
 #include <Windows.h>
+#endif
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <stop_token>
 #include <stdexcept>
 #include <string_view>
 #include <thread>
 #include <unordered_map>
-#include <unordered_set>
 
-#include "frame.hpp"
-#include "wake_event.hpp"
-#include "message_queue.hpp"
+#include "event_record_stream.hpp"
+#include "frame_pacer.hpp"
+#include "mpsc_fifo.hpp"
 #include "platform_request.hpp"
+#include "profiler.hpp"
 #include "record.hpp"
 #include "render_request.hpp"
 #include "render_snapshot.hpp"
+#include "slot_map.hpp"
+#include "spsc_fifo.hpp"
+#include "task.hpp"
 #include "thread_safe_fifo.hpp"
-#include "thread_safe_slot.hpp"
+#include "triple_buffer.hpp"
 #include "update_context.hpp"
 #include "update_request.hpp"
+#include "wake_signal.hpp"
+
+#if defined(SPARKLE_PLATFORM_WINAPI)
+#include "frame.hpp"
+#include "message_queue.hpp"
+#include "wake_event.hpp"
+#elif defined(SPARKLE_PLATFORM_HEADLESS)
+#include "headless_frame.hpp"
+#include "headless_wake_event.hpp"
+#endif
 
 namespace spk
 {
-	class PlatformRequestProducer
+	template <typename TFIFO, typename TWakeEvent>
+	class WakingProducer
 	{
 	private:
-		spk::ThreadSafeFIFO<PlatformRequest>::Producer _producer;
-		WinAPI::WakeEvent &_wakeEvent;
+		typename TFIFO::Producer _producer;
+		TWakeEvent &_wakeEvent;
 
 	public:
-		PlatformRequestProducer(
-			spk::ThreadSafeFIFO<PlatformRequest>::Producer producer,
-			WinAPI::WakeEvent &wakeEvent) :
+		WakingProducer(typename TFIFO::Producer producer, TWakeEvent &wakeEvent) :
 			_producer(std::move(producer)),
 			_wakeEvent(wakeEvent)
 		{
 		}
 
-		void publish(PlatformRequest request)
+		void publish(typename TFIFO::value_type value)
 		{
-			_producer.publish(std::move(request));
+			_producer.publish(std::move(value));
+			_wakeEvent.notify();
+		}
+
+		void publishBatch(std::span<typename TFIFO::value_type> values)
+		{
+			if (values.empty())
+				return;
+			_producer.publishBatch(values);
 			_wakeEvent.notify();
 		}
 	};
 
+	using EventRecordFIFO = spk::SPSCFIFO<EventRecord>;
+	// Injected records arrive in batches, where MPSCFIFO costs one allocation per batch; requests are published one
+	// at a time, where ThreadSafeFIFO's single lock still beats a per-value allocation.
+	using InjectedRecordFIFO = spk::MPSCFIFO<EventRecord>;
+	using PlatformRequestFIFO = spk::ThreadSafeFIFO<PlatformRequest>;
+	using UpdateRequestFIFO = spk::ThreadSafeFIFO<UpdateRequest>;
+	using RenderRequestFIFO = spk::ThreadSafeFIFO<RenderRequest>;
+
+	using PlatformRequestProducer = WakingProducer<PlatformRequestFIFO, Platform::WakeEvent>;
+	using InjectedRecordProducer = WakingProducer<InjectedRecordFIFO, Platform::WakeEvent>;
+	using EventRecordProducer = WakingProducer<EventRecordFIFO, spk::WakeSignal>;
+	using UpdateRequestProducer = WakingProducer<UpdateRequestFIFO, spk::WakeSignal>;
+	using RenderRequestProducer = WakingProducer<RenderRequestFIFO, spk::WakeSignal>;
+
 	struct Application::Channels
 	{
-		spk::ThreadSafeFIFO<EventRecord>::Endpoints eventRecords;
-		spk::ThreadSafeFIFO<PlatformRequest>::Endpoints platformRequests;
-		spk::ThreadSafeFIFO<UpdateRequest>::Endpoints updateRequests;
-		spk::ThreadSafeFIFO<RenderRequest>::Endpoints renderRequests;
+		EventRecordFIFO::Endpoints eventRecords;
+		InjectedRecordFIFO::Endpoints injectedRecords;
+		PlatformRequestFIFO::Endpoints platformRequests;
+		UpdateRequestFIFO::Endpoints updateRequests;
+		RenderRequestFIFO::Endpoints renderRequests;
+
+		explicit Channels(const Configuration &configuration);
+	};
+
+	/** Per-window bookkeeping each runtime keeps next to its object, so a tick needs no second lookup. */
+	struct NativeEntry
+	{
+		bool isMouseInside = false;
+	};
+
+	struct StateEntry
+	{
+		spk::TripleBuffer<spk::RenderSnapshot>::Producer producer;
+		std::shared_ptr<std::atomic_bool> isRequested;
+		std::shared_ptr<spk::RenderCommandArena::Pool> commandPool = std::make_shared<spk::RenderCommandArena::Pool>();
+		std::shared_ptr<spk::RenderCommandArena::Pool> fragmentPool = std::make_shared<spk::RenderCommandArena::Pool>(spk::RenderSnapshot::Fragment::DefaultChunkSize);
+		std::optional<std::uint64_t> publishedRevision = std::nullopt;
+		std::shared_ptr<Window::Latency> latency;
+		std::optional<spk::RenderSnapshot::Clock::time_point> pendingInputTimestamp = std::nullopt;
+		spk::RenderSnapshot::Clock::time_point pendingInputDispatchTimestamp = {};
+	};
 
-		Channels();
+	struct SurfaceEntry
+	{
+		spk::TripleBuffer<spk::RenderSnapshot>::Consumer consumer;
+		std::shared_ptr<std::atomic_bool> isRequested;
+		bool hasPendingSnapshot = false;
+		std::optional<std::uint64_t> lastRenderedRevision = std::nullopt;
+		spk::Vector2UInt lastRenderedSize = {0, 0};
+		std::shared_ptr<Window::Latency> latency;
 	};
 
-	template <typename TType>
+	template <typename TType, typename TEntry>
 	class Application::Runtime
 	{
 	protected:
-		using Identifier = Window::Identifier;
+		using Identifier = Window::Handle;
 		using Pointer = std::shared_ptr<TType>;
-		using Collection = std::unordered_map<Identifier, Pointer>;
+
+		struct Registration
+		{
+			Pointer object;
+			TEntry entry;
+		};
+
+		using Collection = spk::SlotMap<Identifier, Registration>;
 
 	private:
 		Collection _registeredObjects;
 
 	protected:
-		void append(const Identifier &identifier, Pointer object)
+		void append(const Identifier &identifier, Pointer object, TEntry entry = {})
 		{
-			auto [it, inserted] = _registeredObjects.emplace(identifier, std::move(object));
-			if (!inserted)
-				throw std::logic_error("An object is already registered for window [" + identifier + "]");
+			if (_registeredObjects.contains(identifier))
+				throw std::logic_error("An object is already registered for window [" + identifier.toString() + "]");
+			_registeredObjects.emplace(identifier, Registration{std::move(object), std::move(entry)});
 		}
 
 		void remove(const Identifier &identifier) { _registeredObjects.erase(identifier); }
@@ -87,63 +163,88 @@ namespace spk
 
 		[[nodiscard]] TType *tryGet(const Identifier &identifier)
 		{
-			auto it = _registeredObjects.find(identifier);
-			return it != _registeredObjects.end() ? it->second.get() : nullptr;
+			Registration *registration = _registeredObjects.tryGet(identifier);
+			return registration != nullptr ? registration->object.get() : nullptr;
+		}
+
+		[[nodiscard]] TEntry *tryGetEntry(const Identifier &identifier)
+		{
+			Registration *registration = _registeredObjects.tryGet(identifier);
+			return registration != nullptr ? &registration->entry : nullptr;
 		}
 
-		[[nodiscard]] TType &object(const Identifier &identifier) { return *_registeredObjects.at(identifier); }
+		[[nodiscard]] TType &object(const Identifier &identifier) { return *_registeredObjects.at(identifier).object; }
+		[[nodiscard]] Collection &registrations() noexcept { return _registeredObjects; }
 		virtual void consumeIncoming() = 0;
 		virtual void prepareCycle() {}
-		virtual void tickOnce(const Identifier &identifier, TType &object) = 0;
+		virtual void tickOnce(const Identifier &identifier, TType &object, TEntry &entry) = 0;
+
+		virtual void tickAll()
+		{
+			for (auto &[identifier, registration] : _registeredObjects)
+				tickOnce(identifier, *registration.object, registration.entry);
+		}
+
 		virtual void finishCycle() {}
 		virtual void release(TType &) {}
 
 	public:
 		virtual ~Runtime() = default;
 
+		virtual void waitForActivity(std::stop_token) {}
+		virtual void wake() {}
+
 		void executeOnce()
 		{
 			consumeIncoming();
 			prepareCycle();
-			for (auto &[identifier, object] : _registeredObjects)
-				tickOnce(identifier, *object);
+			tickAll();
 			finishCycle();
 		}
 
 		void shutdown()
 		{
-			for (auto &[identifier, object] : _registeredObjects)
-				release(*object);
+			for (auto &[identifier, registration] : _registeredObjects)
+				release(*registration.object);
 			_registeredObjects.clear();
 		}
 	};
 
-	class Application::PlatformRuntime final : public Runtime<Window::Native>
+	class Application::PlatformRuntime final : public Runtime<Window::Native, NativeEntry>
 	{
 	private:
+#if defined(SPARKLE_PLATFORM_WINAPI)
 		using MessageResult = std::optional<LRESULT>;
 		static constexpr std::string_view ClassIdentifier = "sparkle.class";
 
 		WinAPI::Frame::Class _windowClass;
-		WinAPI::WakeEvent &_wakeEvent;
-		std::unordered_set<Window::Identifier> _mouseInsideWindows;
-		spk::ThreadSafeFIFO<PlatformRequest>::Consumer _platformRequestConsumer;
-		spk::ThreadSafeFIFO<EventRecord>::Producer _eventRecordProducer;
-		spk::ThreadSafeFIFO<UpdateRequest>::Producer _updateRequestProducer;
-		spk::ThreadSafeFIFO<RenderRequest>::Producer _renderRequestProducer;
+#endif
+		Platform::WakeEvent &_wakeEvent;
+		PlatformRequestFIFO::Consumer _platformRequestConsumer;
+		InjectedRecordFIFO::Consumer _injectedRecordConsumer;
+		EventRecordProducer _eventRecordProducer;
+		UpdateRequestProducer _updateRequestProducer;
+		RenderRequestProducer _renderRequestProducer;
+		std::shared_ptr<spk::EventRecordWriter> _eventRecordWriter;
 
 		void _createNative(const NativeRegistrationRequest &request);
 		void _destroyNative(Window::Native &native);
+		void _consume(const NativeRegistrationRequest &request);
+		void _consume(const NativeDeletionRequest &request);
+		void _consume(const EventRecordingRequest &request);
+		void _consumeRequests();
+		void _publishEvent(EventRecord record);
+		void _publishEvents(std::span<EventRecord> records);
+		void _inject(std::span<EventRecord> records);
+		void _consumeInjectedRecords();
 
+#if defined(SPARKLE_PLATFORM_WINAPI)
 		template <typename TRecord>
 		void _publish(const Identifier &identifier, TRecord record);
 
 		[[nodiscard]] static spk::Vector2Int _mousePosition(LPARAM lParam) noexcept;
 		[[nodiscard]] static spk::Mouse::Button _mouseButton(UINT message) noexcept;
 		[[nodiscard]] static spk::Keyboard::Key _key(WPARAM wParam, LPARAM lParam) noexcept;
-		void _consume(const NativeRegistrationRequest &request);
-		void _consume(const NativeDeletionRequest &request);
-		void _consumeRequests();
 		[[nodiscard]] MessageResult _processWindowMessage(const Identifier &identifier, UINT message, LPARAM lParam);
 		void _trackMouseLeave(HWND handle);
 		void _processMouseMove(const Identifier &identifier, HWND handle, LPARAM lParam);
@@ -162,48 +263,48 @@ namespace spk
 		[[nodiscard]] MessageResult _processKeyboardMessage(const Identifier &identifier, HWND handle, UINT message, WPARAM wParam, LPARAM lParam);
 		LRESULT _processMessage(const Identifier &identifier, HWND handle, UINT message, WPARAM wParam, LPARAM lParam);
 		void _pullEvents();
+#endif
 
 	protected:
 		void consumeIncoming() override;
 		void prepareCycle() override;
-		void tickOnce(const Window::Identifier &identifier, Window::Native &native) override;
+		void tickOnce(const Identifier &identifier, Window::Native &native, NativeEntry &entry) override;
 		void release(Window::Native &native) override;
 
 	public:
 		PlatformRuntime(
-			WinAPI::WakeEvent &wakeEvent,
-			spk::ThreadSafeFIFO<PlatformRequest>::Consumer platformRequestConsumer,
-			spk::ThreadSafeFIFO<EventRecord>::Producer eventRecordProducer,
-			spk::ThreadSafeFIFO<UpdateRequest>::Producer updateRequestProducer,
-			spk::ThreadSafeFIFO<RenderRequest>::Producer renderRequestProducer);
+			Platform::WakeEvent &wakeEvent,
+			PlatformRequestFIFO::Consumer platformRequestConsumer,
+			InjectedRecordFIFO::Consumer injectedRecordConsumer,
+			EventRecordProducer eventRecordProducer,
+			UpdateRequestProducer updateRequestProducer,
+			RenderRequestProducer renderRequestProducer);
+
+		void waitForActivity(std::stop_token stopToken) override;
 
-		void waitForActivity()
+		void wake() override
 		{
-			WinAPI::MessageQueue::waitForActivity(_wakeEvent.handle());
+			_wakeEvent.notify();
 		}
 	};
 
-	class Application::UpdateRuntime final : public Runtime<Window::State>
+	class Application::UpdateRuntime final : public Runtime<Window::State, StateEntry>
 	{
 	private:
-		struct RenderSnapshotEntry
-		{
-			spk::ThreadSafeSlot<spk::RenderSnapshot>::Producer producer;
-			std::shared_ptr<std::atomic_bool> isRequested;
-		};
-
-		spk::ThreadSafeFIFO<EventRecord>::Consumer _eventRecordConsumer;
-		spk::ThreadSafeFIFO<UpdateRequest>::Consumer _updateRequestConsumer;
-		std::unordered_map<Window::Identifier, RenderSnapshotEntry> _renderSnapshotEntries;
-		std::chrono::steady_clock::time_point _startTime;
-		std::chrono::steady_clock::time_point _currentTime;
-		std::optional<std::chrono::steady_clock::time_point> _lastTime;
-		std::chrono::steady_clock::duration _deltaTime = std::chrono::steady_clock::duration::zero();
-
-		void _registerSnapshotProducer(
-			const Window::Identifier &identifier,
-			spk::ThreadSafeSlot<spk::RenderSnapshot>::Producer producer,
-			std::shared_ptr<std::atomic_bool> isRequested);
+		spk::WakeSignal &_wakeSignal;
+		spk::WakeSignal &_rendererWakeSignal;
+		spk::FramePacer &_pacer;
+		spk::JobSystem &_jobSystem;
+		spk::TaskScheduler _taskScheduler;
+		EventRecordFIFO::Consumer _eventRecordConsumer;
+		UpdateRequestFIFO::Consumer _updateRequestConsumer;
+		bool _isSnapshotBuildParallel;
+		std::size_t _snapshotBuildGranularity;
+		bool _isWindowUpdateParallel;
+		spk::FramePacer::UpdateCycle _cycle;
+		bool _hasConsumedInput = false;
+		std::vector<MouseMovedRecord> _mouseMovedHistory;
+		std::vector<MouseWheelScrolledRecord> _mouseWheelScrolledHistory;
 
 		template <typename TEvent>
 		void _applyFocusChanges(const TEvent &event, Window::State &state);
@@ -212,11 +313,14 @@ namespace spk
 		void _dispatch(const TRecord &record, Window::State &state);
 
 		template <typename TRecord>
-		void _dispatchMouse(const TRecord &record, Window::State &state);
+		void _dispatchMouse(const TRecord &record, std::span<const TRecord> history, Window::State &state);
 
 		template <typename TRecord>
 		void _dispatchKeyboard(const TRecord &record, Window::State &state);
 
+		template <typename TRecord>
+		void _trackDispatch(std::span<const TRecord> records);
+
 		template <typename TRecord>
 		[[nodiscard]] Window::State *_state(const TRecord &record);
 
@@ -227,7 +331,9 @@ namespace spk
 		void _consume(const MouseEnteredRecord &record);
 		void _consume(const MouseLeftRecord &record);
 		void _consume(const MouseMovedRecord &record);
+		void _consume(const MouseMovedRecord &record, std::span<const MouseMovedRecord> history);
 		void _consume(const MouseWheelScrolledRecord &record);
+		void _consume(const MouseWheelScrolledRecord &record, std::span<const MouseWheelScrolledRecord> history);
 		void _consume(const MouseButtonPressedRecord &record);
 		void _consume(const MouseButtonReleasedRecord &record);
 		void _consume(const MouseButtonDoubleClickedRecord &record);
@@ -237,75 +343,111 @@ namespace spk
 		void _consume(const EventRecord &event);
 		void _consume(const StateRegistrationRequest &request);
 		void _consume(const StateDeletionRequest &request);
-		void _consumeEvents();
-		void _consumeRequests();
+		[[nodiscard]] static std::size_t _coalescedRunEnd(const EventRecordFIFO::container_type &events, std::size_t first);
+		template <typename TRecord>
+		[[nodiscard]] static std::span<const TRecord> _collectHistory(std::span<EventRecord> events, std::vector<TRecord> &history);
+		void _consumeCoalesced(std::span<EventRecord> events);
+		[[nodiscard]] bool _consumeEvents();
+		[[nodiscard]] bool _consumeRequests();
 		void _resetInput(Window::State &state);
 		void _updateState(Window::State &state, UpdateContext &context);
-		[[nodiscard]] spk::RenderSnapshot _buildRenderSnapshot(Window::State &state);
-		void _publishSnapshot(const Window::Identifier &identifier, spk::RenderSnapshot &&snapshot);
-		bool _consumeSnapshotRequest(const Window::Identifier &identifier);
+		void _buildRenderSnapshot(StateEntry &entry, Window::State &state);
+		void _stampSnapshot(StateEntry &entry);
+		void _publishSnapshot(StateEntry &entry);
+		[[nodiscard]] bool _consumeSnapshotRequest(StateEntry &entry);
 
 	protected:
 		void consumeIncoming() override;
 		void prepareCycle() override;
-		void tickOnce(const Window::Identifier &identifier, Window::State &state) override;
-		void finishCycle() override;
+		void tickOnce(const Identifier &identifier, Window::State &state, StateEntry &entry) override;
+		void tickAll() override;
 		void release(Window::State &state) override;
 
 	public:
 		UpdateRuntime(
-			spk::ThreadSafeFIFO<EventRecord>::Consumer eventRecordConsumer,
-			spk::ThreadSafeFIFO<UpdateRequest>::Consumer updateRequestConsumer);
+			spk::WakeSignal &wakeSignal,
+			spk::WakeSignal &rendererWakeSignal,
+			spk::FramePacer &pacer,
+			EventRecordFIFO::Consumer eventRecordConsumer,
+			UpdateRequestFIFO::Consumer updateRequestConsumer,
+			spk::JobSystem &jobSystem,
+			bool isSnapshotBuildParallel,
+			std::size_t snapshotBuildGranularity,
+			bool isWindowUpdateParallel);
+
+		void waitForActivity(std::stop_token stopToken) override;
+		void closeEventChannel();
+		[[nodiscard]] EventChannelStatistics eventChannelStatistics() const;
+
+		void wake() override
+		{
+			_wakeSignal.notify();
+		}
 	};
 
-	class Application::RenderRuntime final : public Runtime<Window::Surface>
+	class Application::RenderRuntime final : public Runtime<Window::Surface, SurfaceEntry>
 	{
 	private:
-		struct RenderSnapshotEntry
-		{
-			spk::ThreadSafeSlot<spk::RenderSnapshot>::Consumer consumer;
-			std::shared_ptr<std::atomic_bool> isRequested;
-			spk::ThreadSafeSlot<spk::RenderSnapshot>::pointer lastRenderedSnapshot;
-		};
-
+		spk::WakeSignal &_wakeSignal;
+		spk::WakeSignal &_updaterWakeSignal;
+		spk::FramePacer &_pacer;
 		PlatformRequestProducer _platformRequestProducer;
-		spk::ThreadSafeFIFO<RenderRequest>::Consumer _renderRequestConsumer;
-		std::unordered_map<Window::Identifier, RenderSnapshotEntry> _renderSnapshotEnties;
+		RenderRequestFIFO::Consumer _renderRequestConsumer;
+		bool _isRenderDue = true;
+		bool _hasRendered = false;
+		bool _hasDeferredFrame = false;
 
-		void _registerSnapshotConsumer(
-			const Window::Identifier &identifier,
-			spk::ThreadSafeSlot<spk::RenderSnapshot>::Consumer consumer,
-			std::shared_ptr<std::atomic_bool> isRequested);
 		void _createSurface(Window::Surface &surface, const std::weak_ptr<Window::Native> &native);
 		void _destroySurface(Window::Surface &surface);
-		void _render(Window::Surface &surface, const spk::RenderSnapshot &snapshot);
+		[[nodiscard]] bool _render(Window::Surface &surface, const spk::RenderSnapshot &snapshot);
+		void _presentPendingSnapshot(Window::Surface &surface, SurfaceEntry &entry);
+		void _recordPresentLatency(SurfaceEntry &entry, const spk::RenderSnapshot &snapshot);
 		void _consume(const SurfaceRegistrationRequest &request);
 		void _consume(const SurfaceCreationRequest &request);
 		void _consume(const SurfaceResizeRequest &request);
 		void _consume(const SurfaceDeletionRequest &request);
 		void _consumeRequests();
-		[[nodiscard]] RenderSnapshotEntry *_tryGetSnapshotConsumer(const Window::Identifier &identifier);
 
 	protected:
 		void consumeIncoming() override;
-		void tickOnce(const Window::Identifier &identifier, Window::Surface &surface) override;
+		void prepareCycle() override;
+		void tickOnce(const Identifier &identifier, Window::Surface &surface, SurfaceEntry &entry) override;
+		void finishCycle() override;
 		void release(Window::Surface &surface) override;
 
 	public:
 		RenderRuntime(
-			WinAPI::WakeEvent& wakeEvent,
-			spk::ThreadSafeFIFO<RenderRequest>::Consumer renderRequestConsumer,
-			spk::ThreadSafeFIFO<PlatformRequest>::Producer platformRequestProducer);
+			spk::WakeSignal &wakeSignal,
+			spk::WakeSignal &updaterWakeSignal,
+			spk::FramePacer &pacer,
+			Platform::WakeEvent &platformWakeEvent,
+			RenderRequestFIFO::Consumer renderRequestConsumer,
+			PlatformRequestFIFO::Producer platformRequestProducer);
+
+		void waitForActivity(std::stop_token stopToken) override;
+
+		void wake() override
+		{
+			_wakeSignal.notify();
+		}
 	};
 
 	class Application::Impl
 	{
 	private:
-		WinAPI::WakeEvent _platformWakeEvent;
+		Configuration _configuration;
+		Platform::WakeEvent _platformWakeEvent;
+		spk::WakeSignal _updaterWakeSignal;
+		spk::WakeSignal _rendererWakeSignal;
+		spk::FramePacer _pacer;
+		spk::JobSystem _jobSystem;
 		std::unordered_map<Window::Identifier, std::unique_ptr<Window>> _windows;
+		std::vector<std::uint32_t> _windowHandleGenerations;
+		std::vector<std::uint32_t> _freeWindowHandleIndexes;
 		PlatformRequestProducer _platformRequestProducer;
-		spk::ThreadSafeFIFO<UpdateRequest>::Producer _updateRequestProducer;
-		spk::ThreadSafeFIFO<RenderRequest>::Producer _renderRequestProducer;
+		InjectedRecordProducer _injectedRecordProducer;
+		UpdateRequestProducer _updateRequestProducer;
+		RenderRequestProducer _renderRequestProducer;
 		PlatformRuntime _platform;
 		UpdateRuntime _updater;
 		RenderRuntime _renderer;
@@ -314,24 +456,27 @@ namespace spk
 		std::mutex _workerExceptionMutex;
 		std::exception_ptr _workerException = nullptr;
 
-		explicit Impl(Channels channels);
+		Impl(const Configuration &configuration, Channels channels);
 
 		template <typename TRuntime>
 		void _shutdownWorker(TRuntime &runtime);
 
 		template <typename TRuntime>
-		void _runWorker(TRuntime &runtime, std::stop_token stopToken);
+		void _runWorker(TRuntime &runtime, const char *threadName, std::stop_token stopToken);
 
 		template <typename TRuntime>
-		[[nodiscard]] std::jthread _startWorker(TRuntime &runtime);
+		[[nodiscard]] std::jthread _startWorker(TRuntime &runtime, const char *threadName);
 
 		void _reportWorkerFailure(std::exception_ptr exception);
 		void _rethrowWorkerFailure();
 		void _stopAndJoinWorkers(std::jthread &updaterThread, std::jthread &rendererThread);
-		void _registerWindowObjects(const Window::Identifier &identifier, const Window::Configuration &configuration,
+		[[nodiscard]] Window::Handle _acquireWindowHandle();
+		void _releaseWindowHandle(Window::Handle handle);
+		void _registerWindowObjects(Window::Handle handle, const Window::Configuration &configuration,
 			std::shared_ptr<Window::Native> native, std::shared_ptr<Window::State> state, std::shared_ptr<Window::Surface> surface,
-			spk::ThreadSafeSlot<spk::RenderSnapshot>::Endpoints channel, std::shared_ptr<std::atomic_bool> isRenderSnapshotRequested);
-		void _requestWindowClosure(const Window::Identifier &identifier);
+			spk::TripleBuffer<spk::RenderSnapshot>::Endpoints channel, std::shared_ptr<std::atomic_bool> isRenderSnapshotRequested,
+			std::shared_ptr<Window::Latency> latency);
+		void _requestWindowClosure(Window::Handle handle);
 		void _requestAllWindowClosures();
 		void _removeClosedWindows();
 		void _finishExecution();
@@ -340,12 +485,18 @@ namespace spk
 		void _shutdownAfterFailure() noexcept;
 
 	public:
-		Impl();
+		explicit Impl(const Configuration &configuration);
 		[[nodiscard]] Window &window(const Window::Identifier &identifier);
 		[[nodiscard]] const Window &window(const Window::Identifier &identifier) const;
 		Window &createWindow(const Window::Identifier &identifier, const Window::Configuration &configuration);
 		void closeWindow(const Window::Identifier &identifier);
 		void quit(int exitCode);
+		void inject(EventRecord record);
+		void inject(std::vector<EventRecord> records);
+		void startRecording(std::shared_ptr<EventRecordWriter> writer);
+		void stopRecording();
 		int run();
+		[[nodiscard]] WakeStatistics wakeStatistics() const;
+		[[nodiscard]] EventChannelStatistics eventChannelStatistics() const;
 	};
 }
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "software_framebuffer.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPARKLE_SOFTWARE_RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace spk::SoftwareRaster
+{
+	using Pixel = SoftwareFramebuffer::Pixel;
+
+	inline void fill(Pixel *destination, std::size_t count, Pixel value) noexcept
+	{
+#if defined(SPARKLE_SOFTWARE_RASTER_SSE2)
+		const __m128i block = _mm_set1_epi32(static_cast<int>(value));
+		std::size_t index = 0;
+		for (; index + 16 <= count; index += 16)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index), block);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index + 4), block);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index + 8), block);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index + 12), block);
+		}
+		for (; index + 4 <= count; index += 4)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index), block);
+		std::fill(destination + index, destination + count, value);
+#else
+		std::fill(destination, destination + count, value);
+#endif
+	}
+
+	inline void blit(Pixel *destination, const Pixel *source, std::size_t count) noexcept
+	{
+#if defined(SPARKLE_SOFTWARE_RASTER_SSE2)
+		std::size_t index = 0;
+		for (; index + 8 <= count; index += 8)
+		{
+			const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + index));
+			const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + index + 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index), first);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index + 4), second);
+		}
+		for (; index + 4 <= count; index += 4)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index), _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + index)));
+		std::copy(source + index, source + count, destination + index);
+#else
+		std::memcpy(destination, source, count * sizeof(Pixel));
+#endif
+	}
+}
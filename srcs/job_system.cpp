@@ -0,0 +1,270 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "profiler.hpp"
+
+namespace spk
+{
+	namespace
+	{
+		thread_local const JobSystem *currentSystem = nullptr;
+		thread_local std::size_t currentWorkerIndex = 0;
+	}
+
+	JobSystem::TaskGroup::TaskGroup(JobSystem &system) :
+		_system(system)
+	{
+	}
+
+	JobSystem::TaskGroup::~TaskGroup()
+	{
+		_system._waitFor(*this);
+	}
+
+	void JobSystem::TaskGroup::_complete(std::exception_ptr exception)
+	{
+		if (exception != nullptr)
+		{
+			const std::scoped_lock lock(_exceptionMutex);
+			if (_exception == nullptr)
+				_exception = std::move(exception);
+		}
+
+		// The waiter may destroy the group as soon as the count reaches zero, so the system is read beforehand.
+		JobSystem &system = _system;
+		if (_pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			system._notifyAll();
+	}
+
+	void JobSystem::TaskGroup::run(Job job)
+	{
+		_pendingCount.fetch_add(1, std::memory_order_relaxed);
+		_system._push(Task{.job = std::move(job), .group = this});
+	}
+
+	void JobSystem::TaskGroup::wait()
+	{
+		_system._waitFor(*this);
+
+		std::exception_ptr exception;
+		{
+			const std::scoped_lock lock(_exceptionMutex);
+			exception = std::exchange(_exception, nullptr);
+		}
+		if (exception != nullptr)
+			std::rethrow_exception(exception);
+	}
+
+	std::size_t JobSystem::defaultWorkerCount() noexcept
+	{
+		const std::size_t hardwareThreadCount = std::thread::hardware_concurrency();
+		return hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 0;
+	}
+
+	JobSystem::JobSystem(std::size_t workerCount) :
+		_workerCount(workerCount)
+	{
+		_workers.reserve(workerCount);
+		for (std::size_t index = 0; index < workerCount; ++index)
+			_workers.push_back(std::make_unique<Worker>());
+	}
+
+	JobSystem::~JobSystem()
+	{
+		stop();
+	}
+
+	void JobSystem::start()
+	{
+		if (isRunning() || _workerCount == 0)
+			return;
+
+		{
+			const std::scoped_lock lock(_sleepMutex);
+			_isStopping = false;
+		}
+		_threads.reserve(_workerCount);
+		for (std::size_t index = 0; index < _workerCount; ++index)
+			_threads.emplace_back([this, index] { _work(index); });
+	}
+
+	void JobSystem::stop()
+	{
+		{
+			const std::scoped_lock lock(_sleepMutex);
+			_isStopping = true;
+		}
+		_sleepCondition.notify_all();
+		_threads.clear();
+	}
+
+	bool JobSystem::isRunning() const noexcept
+	{
+		return !_threads.empty();
+	}
+
+	std::size_t JobSystem::workerCount() const noexcept
+	{
+		return _workerCount;
+	}
+
+	JobSystem::Worker *JobSystem::_currentWorker() const noexcept
+	{
+		return currentSystem == this ? _workers[currentWorkerIndex].get() : nullptr;
+	}
+
+	void JobSystem::_push(Task task)
+	{
+		if (Worker *worker = _currentWorker(); worker != nullptr)
+		{
+			const std::scoped_lock lock(worker->mutex);
+			worker->tasks.push_back(std::move(task));
+		}
+		else
+		{
+			const std::scoped_lock lock(_injectionMutex);
+			_injectedTasks.push_back(std::move(task));
+		}
+		_queuedCount.fetch_add(1, std::memory_order_seq_cst);
+
+		{
+			const std::scoped_lock lock(_sleepMutex);
+		}
+		_sleepCondition.notify_one();
+	}
+
+	bool JobSystem::_tryPop(Task &task, const Worker *worker)
+	{
+		const auto take = [this, &task](std::mutex &mutex, std::deque<Task> &tasks, bool fromBack) {
+			const std::scoped_lock lock(mutex);
+			if (tasks.empty())
+				return false;
+			if (fromBack)
+			{
+				task = std::move(tasks.back());
+				tasks.pop_back();
+			}
+			else
+			{
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		};
+
+		if (worker != nullptr && take(_workers[currentWorkerIndex]->mutex, _workers[currentWorkerIndex]->tasks, true))
+			return true;
+		if (take(_injectionMutex, _injectedTasks, false))
+			return true;
+
+		// Victims are visited starting after the current worker so that thieves spread over different deques.
+		const std::size_t firstVictim = worker != nullptr ? currentWorkerIndex + 1 : 0;
+		for (std::size_t offset = 0; offset < _workers.size(); ++offset)
+		{
+			Worker &victim = *_workers[(firstVictim + offset) % _workers.size()];
+			if (&victim != worker && take(victim.mutex, victim.tasks, false))
+				return true;
+		}
+		return false;
+	}
+
+	bool JobSystem::_tryRunOne(const Worker *worker)
+	{
+		Task task;
+		if (!_tryPop(task, worker))
+			return false;
+		_execute(task);
+		return true;
+	}
+
+	void JobSystem::_execute(Task &task)
+	{
+		std::exception_ptr exception = nullptr;
+		try
+		{
+			task.job();
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+		task.group->_complete(std::move(exception));
+	}
+
+	void JobSystem::_notifyAll()
+	{
+		{
+			const std::scoped_lock lock(_sleepMutex);
+		}
+		_sleepCondition.notify_all();
+	}
+
+	void JobSystem::_work(std::size_t index)
+	{
+		currentSystem = this;
+		currentWorkerIndex = index;
+		SPARKLE_PROFILE_THREAD("job worker " + std::to_string(index));
+		const Worker *worker = _workers[index].get();
+
+		while (true)
+		{
+			if (_tryRunOne(worker))
+				continue;
+
+			std::unique_lock lock(_sleepMutex);
+			_sleepCondition.wait(lock, [this] { return _isStopping || _queuedCount.load(std::memory_order_seq_cst) != 0; });
+			if (_isStopping)
+				return;
+		}
+	}
+
+	void JobSystem::_waitFor(const TaskGroup &group)
+	{
+		const Worker *worker = _currentWorker();
+		while (group._pendingCount.load(std::memory_order_acquire) != 0)
+		{
+			if (_tryRunOne(worker))
+				continue;
+
+			std::unique_lock lock(_sleepMutex);
+			_sleepCondition.wait(
+				lock,
+				[this, &group] {
+					return group._pendingCount.load(std::memory_order_acquire) == 0 ||
+						   _queuedCount.load(std::memory_order_seq_cst) != 0;
+				});
+		}
+	}
+
+	void JobSystem::parallelFor(std::size_t count, const RangeJob &job, std::size_t granularity)
+	{
+		granularity = std::max<std::size_t>(granularity, 1);
+		if (count <= granularity)
+		{
+			if (count != 0)
+				job(0, count);
+			return;
+		}
+
+		// Ranges are halved recursively: the upper half is left for thieves while the lower half keeps being split
+		// locally, so idle workers always steal the largest remaining pieces.
+		// split is declared first so that, if job throws here, ~TaskGroup waits for the stolen halves still using it.
+		std::function<void(std::size_t, std::size_t)> split;
+		TaskGroup group(*this);
+		split = [&](std::size_t begin, std::size_t end) {
+			while (end - begin > granularity)
+			{
+				const std::size_t middle = begin + (end - begin) / 2;
+				group.run([&split, middle, end] { split(middle, end); });
+				end = middle;
+			}
+			job(begin, end);
+		};
+		split(0, count);
+		group.wait();
+	}
+}
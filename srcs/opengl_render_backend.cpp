@@ -0,0 +1,70 @@
+#include "opengl_render_backend.hpp"
+
+#include <GL/glew.h>
+
+#include "render_pass.hpp"
+
+namespace spk
+{
+	int OpenGLRenderBackend::_flippedY(const spk::Rect2D &area) const noexcept
+	{
+		return static_cast<GLint>(_frameSize.y) - area.y - static_cast<GLint>(area.height);
+	}
+
+	void OpenGLRenderBackend::execute(const RenderPass &pass, RenderContext &renderContext)
+	{
+		pass.play(*this, renderContext);
+	}
+
+	void OpenGLRenderBackend::beginFrame(const spk::Vector2UInt &size)
+	{
+		_frameSize = size;
+		::glDisable(GL_SCISSOR_TEST);
+	}
+
+	void OpenGLRenderBackend::setViewport(const spk::Rect2D &viewport)
+	{
+		::glViewport(
+			static_cast<GLint>(viewport.x),
+			_flippedY(viewport),
+			static_cast<GLsizei>(viewport.width),
+			static_cast<GLsizei>(viewport.height));
+	}
+
+	void OpenGLRenderBackend::setScissor(const spk::Rect2D &scissor)
+	{
+		// Not cached: custom commands may have disabled the scissor test. Redundant scissors are elided at build time.
+		::glEnable(GL_SCISSOR_TEST);
+		::glScissor(
+			static_cast<GLint>(scissor.x),
+			_flippedY(scissor),
+			static_cast<GLsizei>(scissor.width),
+			static_cast<GLsizei>(scissor.height));
+	}
+
+	void OpenGLRenderBackend::clear(const spk::Color &color, ClearRenderCommand::Mask mask)
+	{
+		using Mask = ClearRenderCommand::Mask;
+
+		GLbitfield bits = 0;
+
+		if ((mask & Mask::Color) != Mask::None)
+			bits |= GL_COLOR_BUFFER_BIT;
+
+		if ((mask & Mask::Depth) != Mask::None)
+			bits |= GL_DEPTH_BUFFER_BIT;
+
+		if ((mask & Mask::Stencil) != Mask::None)
+			bits |= GL_STENCIL_BUFFER_BIT;
+
+		if ((mask & Mask::Color) != Mask::None)
+			::glClearColor(color.r, color.g, color.b, color.a);
+
+		if (bits != 0)
+			::glClear(bits);
+	}
+
+	void OpenGLRenderBackend::endFrame()
+	{
+	}
+}
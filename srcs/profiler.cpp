@@ -0,0 +1,206 @@
+#include "profiler.hpp"
+
+#include <atomic>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace spk
+{
+	namespace
+	{
+		struct ProfiledEvent
+		{
+			const char *name = nullptr;
+			Profiler::Clock::time_point start;
+			Profiler::Clock::time_point end;
+		};
+
+		struct ThreadBuffer
+		{
+			static constexpr std::size_t CacheLineSize = 64;
+
+			std::uint32_t threadIdentifier = 0;
+			std::string threadName;
+			std::unique_ptr<ProfiledEvent[]> events = std::make_unique<ProfiledEvent[]>(Profiler::ThreadCapacity);
+			alignas(CacheLineSize) std::atomic<std::size_t> head = 0;
+			alignas(CacheLineSize) std::atomic<std::size_t> tail = 0;
+			std::atomic<std::uint64_t> recordedCount = 0;
+			std::atomic<std::uint64_t> droppedCount = 0;
+		};
+
+		struct Registry
+		{
+			const Profiler::Clock::time_point epoch = Profiler::Clock::now();
+			std::mutex mutex;
+			std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+			std::unordered_set<std::string> internedNames;
+			std::atomic<bool> areWidgetScopesEnabled = false;
+		};
+
+		Registry &registry()
+		{
+			static Registry result;
+			return result;
+		}
+
+		thread_local std::shared_ptr<ThreadBuffer> currentBuffer;
+		thread_local std::unordered_map<std::string, const char *> currentInternedNames;
+
+		ThreadBuffer &threadBuffer()
+		{
+			if (currentBuffer == nullptr)
+			{
+				auto buffer = std::make_shared<ThreadBuffer>();
+				Registry &instance = registry();
+				const std::scoped_lock lock(instance.mutex);
+				buffer->threadIdentifier = static_cast<std::uint32_t>(instance.buffers.size() + 1);
+				instance.buffers.push_back(buffer);
+				currentBuffer = std::move(buffer);
+			}
+			return *currentBuffer;
+		}
+
+		void writeMicroseconds(std::ostream &stream, Profiler::Clock::duration duration)
+		{
+			const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+			const char previousFill = stream.fill('0');
+			stream << nanoseconds / 1000 << '.' << std::setw(3) << nanoseconds % 1000;
+			stream.fill(previousFill);
+		}
+
+		void writeEscaped(std::ostream &stream, std::string_view text)
+		{
+			stream << '"';
+			for (const char character : text)
+			{
+				switch (character)
+				{
+				case '"':
+					stream << "\\\"";
+					break;
+				case '\\':
+					stream << "\\\\";
+					break;
+				default:
+					if (static_cast<unsigned char>(character) < 0x20)
+						stream << ' ';
+					else
+						stream << character;
+					break;
+				}
+			}
+			stream << '"';
+		}
+	}
+
+	void Profiler::record(const char *name, Clock::time_point start, Clock::time_point end) noexcept
+	{
+		try
+		{
+			ThreadBuffer &buffer = threadBuffer();
+			const std::size_t head = buffer.head.load(std::memory_order_relaxed);
+			if (head - buffer.tail.load(std::memory_order_acquire) == ThreadCapacity)
+			{
+				buffer.droppedCount.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			buffer.events[head % ThreadCapacity] = ProfiledEvent{.name = name, .start = start, .end = end};
+			buffer.head.store(head + 1, std::memory_order_release);
+			buffer.recordedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		catch (...)
+		{
+			// Profiling must never disturb the profiled code: a thread that cannot get a buffer just records nothing.
+		}
+	}
+
+	const char *Profiler::intern(std::string_view name)
+	{
+		const std::string key(name);
+		if (const auto iterator = currentInternedNames.find(key); iterator != currentInternedNames.end())
+			return iterator->second;
+
+		Registry &instance = registry();
+		const char *result = nullptr;
+		{
+			const std::scoped_lock lock(instance.mutex);
+			result = instance.internedNames.insert(key).first->c_str();
+		}
+		currentInternedNames.emplace(key, result);
+		return result;
+	}
+
+	void Profiler::setThreadName(std::string_view name)
+	{
+		ThreadBuffer &buffer = threadBuffer();
+		const std::scoped_lock lock(registry().mutex);
+		buffer.threadName = name;
+	}
+
+	void Profiler::setWidgetScopesEnabled(bool isEnabled) noexcept
+	{
+		registry().areWidgetScopesEnabled.store(isEnabled, std::memory_order_relaxed);
+	}
+
+	bool Profiler::areWidgetScopesEnabled() noexcept
+	{
+		return registry().areWidgetScopesEnabled.load(std::memory_order_relaxed);
+	}
+
+	void Profiler::exportChromeTrace(std::ostream &stream)
+	{
+		Registry &instance = registry();
+		const std::scoped_lock lock(instance.mutex);
+
+		const char *separator = "";
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		for (const std::shared_ptr<ThreadBuffer> &buffer : instance.buffers)
+		{
+			if (!buffer->threadName.empty())
+			{
+				stream << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadIdentifier
+					   << ",\"args\":{\"name\":";
+				writeEscaped(stream, buffer->threadName);
+				stream << "}}";
+				separator = ",";
+			}
+
+			const std::size_t head = buffer->head.load(std::memory_order_acquire);
+			std::size_t tail = buffer->tail.load(std::memory_order_relaxed);
+			for (; tail != head; ++tail)
+			{
+				const ProfiledEvent &event = buffer->events[tail % ThreadCapacity];
+				stream << separator << "{\"name\":";
+				writeEscaped(stream, event.name);
+				stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIdentifier << ",\"ts\":";
+				writeMicroseconds(stream, event.start - instance.epoch);
+				stream << ",\"dur\":";
+				writeMicroseconds(stream, event.end - event.start);
+				stream << '}';
+				separator = ",";
+			}
+			buffer->tail.store(tail, std::memory_order_release);
+		}
+		stream << "]}";
+	}
+
+	Profiler::Statistics Profiler::statistics()
+	{
+		Registry &instance = registry();
+		const std::scoped_lock lock(instance.mutex);
+
+		Statistics result;
+		for (const std::shared_ptr<ThreadBuffer> &buffer : instance.buffers)
+		{
+			result.recordedCount += buffer->recordedCount.load(std::memory_order_relaxed);
+			result.droppedCount += buffer->droppedCount.load(std::memory_order_relaxed);
+		}
+		return result;
+	}
+}
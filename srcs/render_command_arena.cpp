@@ -0,0 +1,122 @@
+#include "render_command_arena.hpp"
+
+#include <stdexcept>
+
+namespace spk
+{
+	RenderCommandArena::Pool::Pool(std::size_t chunkSize, std::size_t retainedChunkCount) :
+		_chunkSize(chunkSize),
+		_retainedChunkCount(retainedChunkCount)
+	{
+		if (chunkSize == 0)
+			throw std::invalid_argument("A render command arena pool requires a positive chunk size");
+	}
+
+	std::size_t RenderCommandArena::Pool::chunkSize() const noexcept
+	{
+		return _chunkSize;
+	}
+
+	std::size_t RenderCommandArena::Pool::retainedChunks() const
+	{
+		const std::scoped_lock lock(_mutex);
+		return _chunks.size();
+	}
+
+	RenderCommandArena::Chunk RenderCommandArena::Pool::acquire()
+	{
+		{
+			const std::scoped_lock lock(_mutex);
+			if (!_chunks.empty())
+			{
+				Chunk result = std::move(_chunks.back());
+				_chunks.pop_back();
+				return result;
+			}
+		}
+		return Chunk{.memory = std::make_unique_for_overwrite<std::byte[]>(_chunkSize), .size = _chunkSize};
+	}
+
+	void RenderCommandArena::Pool::release(Chunk &&chunk)
+	{
+		if (chunk.size != _chunkSize)
+			return;
+		const std::scoped_lock lock(_mutex);
+		if (_chunks.size() < _retainedChunkCount)
+			_chunks.push_back(std::move(chunk));
+	}
+
+	RenderCommandArena::RenderCommandArena() :
+		RenderCommandArena(nullptr)
+	{
+	}
+
+	RenderCommandArena::RenderCommandArena(std::shared_ptr<Pool> pool) :
+		_pool(std::move(pool))
+	{
+	}
+
+	RenderCommandArena::~RenderCommandArena()
+	{
+		if (_pool == nullptr)
+			return;
+		for (Chunk &chunk : _chunks)
+			_pool->release(std::move(chunk));
+	}
+
+	std::size_t RenderCommandArena::_chunkSize() const noexcept
+	{
+		return _pool != nullptr ? _pool->chunkSize() : DefaultChunkSize;
+	}
+
+	RenderCommandArena::Chunk RenderCommandArena::_acquireChunk(std::size_t minimalSize)
+	{
+		const std::size_t chunkSize = _chunkSize();
+		if (minimalSize > chunkSize)
+			return Chunk{.memory = std::make_unique_for_overwrite<std::byte[]>(minimalSize), .size = minimalSize};
+		if (_pool != nullptr)
+			return _pool->acquire();
+		return Chunk{.memory = std::make_unique_for_overwrite<std::byte[]>(chunkSize), .size = chunkSize};
+	}
+
+	void *RenderCommandArena::_tryAllocate(std::size_t size, std::size_t alignment) noexcept
+	{
+		if (_chunks.empty())
+			return nullptr;
+
+		Chunk &chunk = _chunks.back();
+		void *cursor = chunk.memory.get() + _offset;
+		std::size_t space = chunk.size - _offset;
+		if (std::align(alignment, size, cursor, space) == nullptr)
+			return nullptr;
+
+		_offset = chunk.size - space + size;
+		_usedBytes += size;
+		return cursor;
+	}
+
+	void *RenderCommandArena::_allocate(std::size_t size, std::size_t alignment)
+	{
+		if (void *result = _tryAllocate(size, alignment))
+			return result;
+
+		_chunks.push_back(_acquireChunk(size + alignment));
+		_offset = 0;
+		return _tryAllocate(size, alignment);
+	}
+
+	const std::shared_ptr<RenderCommandArena::Pool> &RenderCommandArena::pool() const noexcept
+	{
+		return _pool;
+	}
+
+	std::size_t RenderCommandArena::usedBytes() const noexcept
+	{
+		return _usedBytes;
+	}
+
+	std::size_t RenderCommandArena::chunkCount() const noexcept
+	{
+		return _chunks.size();
+	}
+}
@@ -1,26 +1,149 @@
 #include "render_pass.hpp"
 
-#include "render_command.hpp"
+#include "render_context.hpp"
 
+#include <memory>
 #include <utility>
 
 namespace spk
 {
-	RenderPass::RenderPass() = default;
-	RenderPass::RenderPass(RenderPass &&) noexcept = default;
-	RenderPass::~RenderPass() = default;
-	RenderPass &RenderPass::operator=(RenderPass &&) noexcept = default;
+	RenderPass::RenderPass(RenderCommandArena &arena) :
+		_arena(&arena)
+	{
+	}
 
-	void RenderPass::append(std::unique_ptr<const RenderCommand> renderCommand)
+	RenderPass::RenderPass(RenderPass &&other) noexcept :
+		_arena(other._arena),
+		_stream(std::exchange(other._stream, {})),
+		_customCommands(std::exchange(other._customCommands, {})),
+		_commandCount(std::exchange(other._commandCount, 0))
 	{
-		_commands.push_back(std::move(renderCommand));
 	}
 
-	void RenderPass::execute(RenderContext &renderContext) const
+	RenderPass::~RenderPass()
 	{
-		for (const auto &command : _commands)
+		_destroyCommands();
+	}
+
+	RenderPass &RenderPass::operator=(RenderPass &&other) noexcept
+	{
+		if (this != &other)
 		{
-			command->execute(renderContext);
+			_destroyCommands();
+			_arena = other._arena;
+			_stream = std::exchange(other._stream, {});
+			_customCommands = std::exchange(other._customCommands, {});
+			_commandCount = std::exchange(other._commandCount, 0);
 		}
+		return *this;
+	}
+
+	void RenderPass::_destroyCommands() noexcept
+	{
+		for (const RenderCommand *command : _customCommands)
+		{
+			std::destroy_at(command);
+		}
+		_customCommands.clear();
+		_stream.clear();
+		_commandCount = 0;
+	}
+
+	void RenderPass::_appendCustom(const RenderCommand *command)
+	{
+		_customCommands.push_back(command);
+		_write(Opcode::Custom, command);
+	}
+
+	void RenderPass::_flushState(StateTracker &tracker)
+	{
+		if (tracker.pendingViewport.has_value() && tracker.pendingViewport != tracker.appliedViewport)
+		{
+			_write(Opcode::Viewport, *tracker.pendingViewport);
+			tracker.appliedViewport = tracker.pendingViewport;
+		}
+		if (tracker.pendingScissor.has_value() && tracker.pendingScissor != tracker.appliedScissor)
+		{
+			_write(Opcode::Scissor, *tracker.pendingScissor);
+			tracker.appliedScissor = tracker.pendingScissor;
+		}
+		tracker.pendingViewport.reset();
+		tracker.pendingScissor.reset();
+	}
+
+	void RenderPass::elideRedundantState(StateTracker &tracker)
+	{
+		const std::vector<std::byte> source = std::exchange(_stream, {});
+		_stream.reserve(source.size());
+		_commandCount = 0;
+
+		const std::byte *cursor = source.data();
+		const std::byte *const end = cursor + source.size();
+		while (cursor != end)
+		{
+			const auto opcode = static_cast<Opcode>(*cursor++);
+			switch (opcode)
+			{
+			case Opcode::Viewport:
+				tracker.pendingViewport = _read<Rect2D>(cursor);
+				break;
+			case Opcode::Scissor:
+				tracker.pendingScissor = _read<Rect2D>(cursor);
+				break;
+			case Opcode::Clear:
+			{
+				const auto payload = _read<ClearPayload>(cursor);
+				_flushState(tracker);
+				_write(Opcode::Clear, payload);
+				break;
+			}
+			case Opcode::Custom:
+			{
+				const auto *command = _read<const RenderCommand *>(cursor);
+				_flushState(tracker);
+				_write(Opcode::Custom, command);
+				// A custom command may change the backend state behind the stream's back.
+				tracker.appliedViewport.reset();
+				tracker.appliedScissor.reset();
+				break;
+			}
+			}
+		}
+	}
+
+	void RenderPass::clear(const Color &color, ClearRenderCommand::Mask mask)
+	{
+		_write(Opcode::Clear, ClearPayload{.color = color, .mask = mask});
+	}
+
+	void RenderPass::setViewport(const Rect2D &viewport)
+	{
+		_write(Opcode::Viewport, viewport);
+	}
+
+	void RenderPass::setScissor(const Rect2D &scissor)
+	{
+		_write(Opcode::Scissor, scissor);
+	}
+
+	void RenderPass::append(const RenderPass &other)
+	{
+		_stream.insert(_stream.end(), other._stream.begin(), other._stream.end());
+		_commandCount += other._commandCount;
+	}
+
+	std::size_t RenderPass::size() const noexcept
+	{
+		return _commandCount;
+	}
+
+	std::size_t RenderPass::streamSize() const noexcept
+	{
+		return _stream.size();
+	}
+
+	void RenderPass::execute(RenderContext &renderContext) const
+	{
+		renderContext.backend->execute(*this, renderContext);
 	}
 }
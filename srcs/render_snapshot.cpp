@@ -5,6 +5,64 @@
 
 namespace spk
 {
+	RenderSnapshot::Fragment::Fragment(
+		std::vector<std::shared_ptr<const Fragment>> parts,
+		std::unique_ptr<RenderCommandArena> arena,
+		std::vector<Entry> entries) :
+		_parts(std::move(parts)),
+		_arena(std::move(arena)),
+		_entries(std::move(entries))
+	{
+	}
+
+	std::size_t RenderSnapshot::Fragment::size() const noexcept
+	{
+		std::size_t result = 0;
+		for (const auto &part : _parts)
+		{
+			result += part->size();
+		}
+		for (const Entry &entry : _entries)
+		{
+			result += entry.pass.size();
+		}
+		return result;
+	}
+
+	RenderSnapshot::Builder::Builder() :
+		Builder(nullptr)
+	{
+	}
+
+	RenderSnapshot::Builder::Builder(std::shared_ptr<RenderCommandArena::Pool> pool) :
+		Builder(std::move(pool), std::make_shared<RenderCommandArena::Pool>(Fragment::DefaultChunkSize))
+	{
+	}
+
+	RenderSnapshot::Builder::Builder(
+		std::shared_ptr<RenderCommandArena::Pool> pool,
+		std::shared_ptr<RenderCommandArena::Pool> fragmentPool) :
+		_fragmentPool(std::move(fragmentPool)),
+		_arena(std::make_unique<RenderCommandArena>(std::move(pool)))
+	{
+	}
+
+	void RenderSnapshot::Builder::setJobSystem(JobSystem *jobSystem, std::size_t granularity)
+	{
+		_jobSystem = jobSystem;
+		_parallelGranularity = std::max<std::size_t>(granularity, 1);
+	}
+
+	JobSystem *RenderSnapshot::Builder::jobSystem() const noexcept
+	{
+		return _jobSystem;
+	}
+
+	std::size_t RenderSnapshot::Builder::parallelGranularity() const noexcept
+	{
+		return _parallelGranularity;
+	}
+
 	RenderPass &RenderSnapshot::Builder::renderPass(const RenderPass::Key &key)
 	{
 		if (auto *entry = findPass(key.name))
@@ -22,7 +80,7 @@ namespace spk
 			return *entry->pass;
 		}
 
-		auto pass = std::make_unique<RenderPass>();
+		auto pass = std::make_unique<RenderPass>(*_arena);
 		RenderPass &result = *pass;
 
 		_passes.push_back({.key = key, .pass = std::move(pass)});
@@ -30,25 +88,130 @@ namespace spk
 		return result;
 	}
 
-	RenderSnapshot RenderSnapshot::Builder::build()
+	void RenderSnapshot::Builder::splice(const std::shared_ptr<const Fragment> &fragment)
+	{
+		if (fragment == nullptr || (fragment->_parts.empty() && fragment->_entries.empty()))
+		{
+			return;
+		}
+
+		// Commands recorded so far are sealed into their own part, so that they keep playing before the fragment.
+		if (!_passes.empty())
+		{
+			_fragments.push_back(_seal({}));
+		}
+		_fragments.push_back(fragment);
+	}
+
+	RenderSnapshot::Builder RenderSnapshot::Builder::recorder() const
+	{
+		return Builder(_fragmentPool, _fragmentPool);
+	}
+
+	RenderSnapshot RenderSnapshot::Builder::build(std::uint64_t revision)
+	{
+		RenderSnapshot result;
+		build(result, revision);
+		return result;
+	}
+
+	void RenderSnapshot::Builder::build(RenderSnapshot &target, std::uint64_t revision)
 	{
+		if (!_fragments.empty())
+		{
+			if (!_passes.empty())
+			{
+				_fragments.push_back(_seal({}));
+			}
+			for (const auto &fragment : _fragments)
+			{
+				_flatten(*fragment);
+			}
+		}
+
 		std::ranges::stable_sort(
 			_passes,
 			[](const PendingPass &lhs, const PendingPass &rhs) {
 				return lhs.key.order < rhs.key.order;
 			});
 
-		std::vector<std::unique_ptr<const RenderPass>> passes;
-		passes.reserve(_passes.size());
+		// The previous passes must release their commands before the arena holding them goes away.
+		target._renderPasses.clear();
+		target._renderPasses.reserve(_passes.size());
+
+		RenderPass::StateTracker tracker;
+		std::size_t elidedCommandCount = 0;
+		for (auto &entry : _passes)
+		{
+			elidedCommandCount += entry.pass->size();
+			entry.pass->elideRedundantState(tracker);
+			elidedCommandCount -= entry.pass->size();
+			target._renderPasses.push_back(std::move(entry.pass));
+		}
+
+		_passes.clear();
+
+		target._arena = std::exchange(_arena, std::make_unique<RenderCommandArena>(_arena->pool()));
+		target._fragments.clear();
+		target._fragments.swap(_fragments);
+		target._revision = revision;
+		target._elidedCommandCount = elidedCommandCount;
+	}
+
+	std::shared_ptr<const RenderSnapshot::Fragment> RenderSnapshot::Builder::buildFragment()
+	{
+		if (_passes.empty() && _fragments.size() == 1)
+		{
+			return std::exchange(_fragments, {}).front();
+		}
+		return _seal(std::exchange(_fragments, {}));
+	}
+
+	std::shared_ptr<const RenderSnapshot::Fragment> RenderSnapshot::Builder::_seal(std::vector<std::shared_ptr<const Fragment>> parts)
+	{
+		std::vector<Fragment::Entry> entries;
+		entries.reserve(_passes.size());
 
 		for (auto &entry : _passes)
 		{
-			passes.push_back(std::move(entry.pass));
+			entries.push_back({.key = std::move(entry.key), .pass = std::move(*entry.pass)});
 		}
 
 		_passes.clear();
 
-		return RenderSnapshot(std::move(passes));
+		auto arena = std::exchange(_arena, std::make_unique<RenderCommandArena>(_arena->pool()));
+
+		return std::make_shared<const Fragment>(std::move(parts), std::move(arena), std::move(entries));
+	}
+
+	void RenderSnapshot::Builder::_flatten(const Fragment &fragment)
+	{
+		// Walks the fragment tree depth first without recursion, as its depth follows the widget tree's. Consecutive
+		// fragments mostly record into the same pass, so the last one used is checked before searching by name.
+		std::vector<std::pair<const Fragment *, std::size_t>> stack = {{&fragment, 0}};
+		const RenderPass::Key *lastKey = nullptr;
+		RenderPass *lastPass = nullptr;
+		while (!stack.empty())
+		{
+			auto &[current, nextPart] = stack.back();
+			if (nextPart < current->_parts.size())
+			{
+				const Fragment *part = current->_parts[nextPart++].get();
+				stack.emplace_back(part, 0);
+				continue;
+			}
+
+			for (const auto &entry : current->_entries)
+			{
+				if (lastKey == nullptr || entry.key.order != lastKey->order || entry.key.name != lastKey->name)
+				{
+					lastKey = &entry.key;
+					lastPass = &renderPass(entry.key);
+				}
+				lastPass->append(entry.pass);
+			}
+			stack.pop_back();
+		}
 	}
 
 	RenderSnapshot::Builder::PendingPass *
@@ -66,6 +229,38 @@ namespace spk
 				   : nullptr;
 	}
 
+	RenderSnapshot &RenderSnapshot::operator=(RenderSnapshot &&other) noexcept
+	{
+		// The passes must release their commands before the arena holding them goes away.
+		_renderPasses = std::move(other._renderPasses);
+		_arena = std::move(other._arena);
+		_fragments = std::move(other._fragments);
+		_revision = other._revision;
+		_elidedCommandCount = other._elidedCommandCount;
+		_timestamps = other._timestamps;
+		return *this;
+	}
+
+	std::uint64_t RenderSnapshot::revision() const noexcept
+	{
+		return _revision;
+	}
+
+	std::size_t RenderSnapshot::elidedCommandCount() const noexcept
+	{
+		return _elidedCommandCount;
+	}
+
+	const RenderSnapshot::Timestamps &RenderSnapshot::timestamps() const noexcept
+	{
+		return _timestamps;
+	}
+
+	void RenderSnapshot::setTimestamps(const Timestamps &timestamps) noexcept
+	{
+		_timestamps = timestamps;
+	}
+
 	void RenderSnapshot::execute(RenderContext &renderContext) const
 	{
 		for (const auto &pass : _renderPasses)
@@ -73,10 +268,4 @@ namespace spk
 			pass->execute(renderContext);
 		}
 	}
-
-	RenderSnapshot::RenderSnapshot(
-		std::vector<std::unique_ptr<const RenderPass>> passes) :
-		_renderPasses(std::move(passes))
-	{
-	}
 }
@@ -1,8 +1,6 @@
 #include "scissor_render_command.hpp"
 
-#include <Windows.h>
-#include <gl/gl.h>
-
+#include "render_backend.hpp"
 #include "render_context.hpp"
 
 namespace spk
@@ -14,13 +12,6 @@ namespace spk
 
 	void ScissorRenderCommand::execute(RenderContext &renderContext) const
 	{
-		const GLint y = static_cast<GLint>(renderContext.targetSurface->geometry().size.y) - _scissor.y - static_cast<GLint>(_scissor.height);
-
-		::glEnable(GL_SCISSOR_TEST);
-		::glScissor(
-			static_cast<GLint>(_scissor.x),
-			y,
-			static_cast<GLsizei>(_scissor.width),
-			static_cast<GLsizei>(_scissor.height));
+		renderContext.backend->setScissor(_scissor);
 	}
-}
\ No newline at end of file
+}
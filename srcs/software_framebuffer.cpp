@@ -0,0 +1,62 @@
+#include "software_framebuffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace spk
+{
+	namespace
+	{
+		[[nodiscard]] std::uint32_t toChannel(float value) noexcept
+		{
+			return static_cast<std::uint32_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+		}
+	}
+
+	void SoftwareFramebuffer::resize(const spk::Vector2UInt &newSize)
+	{
+		size = newSize;
+		pixels.resize(static_cast<std::size_t>(newSize.x) * newSize.y);
+	}
+
+	SoftwareFramebuffer::Pixel *SoftwareFramebuffer::row(std::uint32_t y) noexcept
+	{
+		return pixels.data() + static_cast<std::size_t>(y) * size.x;
+	}
+
+	const SoftwareFramebuffer::Pixel *SoftwareFramebuffer::row(std::uint32_t y) const noexcept
+	{
+		return pixels.data() + static_cast<std::size_t>(y) * size.x;
+	}
+
+	SoftwareFramebuffer::Pixel SoftwareFramebuffer::pixel(std::uint32_t x, std::uint32_t y) const
+	{
+		if (x >= size.x || y >= size.y)
+			throw std::out_of_range("Pixel coordinates are outside of the framebuffer");
+		return row(y)[x];
+	}
+
+	SoftwareFramebuffer::Pixel SoftwareFramebuffer::pack(const spk::Color &color) noexcept
+	{
+		const std::uint8_t channels[4] = {
+			static_cast<std::uint8_t>(toChannel(color.r)),
+			static_cast<std::uint8_t>(toChannel(color.g)),
+			static_cast<std::uint8_t>(toChannel(color.b)),
+			static_cast<std::uint8_t>(toChannel(color.a))};
+		Pixel result;
+		std::copy_n(reinterpret_cast<const char *>(channels), sizeof(Pixel), reinterpret_cast<char *>(&result));
+		return result;
+	}
+
+	spk::Color SoftwareFramebuffer::unpack(Pixel pixel) noexcept
+	{
+		std::uint8_t channels[4];
+		std::copy_n(reinterpret_cast<const char *>(&pixel), sizeof(Pixel), reinterpret_cast<char *>(channels));
+		return spk::Color{
+			.r = static_cast<float>(channels[0]) / 255.0f,
+			.g = static_cast<float>(channels[1]) / 255.0f,
+			.b = static_cast<float>(channels[2]) / 255.0f,
+			.a = static_cast<float>(channels[3]) / 255.0f};
+	}
+}
@@ -0,0 +1,174 @@
+#include "software_render_backend.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#include "internal/software_raster_kernels.hpp"
+#include "render_pass.hpp"
+
+namespace spk
+{
+	SoftwareRenderBackend::SoftwareRenderBackend() :
+		SoftwareRenderBackend(Configuration{})
+	{
+	}
+
+	SoftwareRenderBackend::SoftwareRenderBackend(const Configuration &configuration) :
+		_configuration(configuration),
+		_frameRecycler(std::make_shared<FrameRecycler>())
+	{
+		if (configuration.tileSize == 0)
+			throw std::invalid_argument("The software render backend tile size must be positive");
+		// Reserved up front so that handing a frame back never allocates from the deleter.
+		_frameRecycler->frames.reserve(RecycledFrameCount);
+	}
+
+	std::unique_ptr<SoftwareFramebuffer> SoftwareRenderBackend::_acquireFrame()
+	{
+		{
+			const std::scoped_lock lock(_frameRecycler->mutex);
+			if (!_frameRecycler->frames.empty())
+			{
+				std::unique_ptr<SoftwareFramebuffer> result = std::move(_frameRecycler->frames.back());
+				_frameRecycler->frames.pop_back();
+				return result;
+			}
+		}
+		return std::make_unique<SoftwareFramebuffer>();
+	}
+
+	spk::Rect2D SoftwareRenderBackend::_frameArea() const noexcept
+	{
+		return spk::Rect2D{.anchor = {0, 0}, .size = _framebuffer.size};
+	}
+
+	void SoftwareRenderBackend::_rasterizeTile(const spk::Rect2D &tile)
+	{
+		for (const FillOperation &operation : _operations)
+		{
+			const spk::Rect2D area = operation.area.intersect(tile);
+			if (area.width == 0 || area.height == 0)
+				continue;
+			for (std::uint32_t row = 0; row < area.height; ++row)
+			{
+				SoftwareFramebuffer::Pixel *destination = _framebuffer.row(static_cast<std::uint32_t>(area.y) + row) + area.x;
+				SoftwareRaster::fill(destination, area.width, operation.value);
+			}
+		}
+	}
+
+	void SoftwareRenderBackend::_rasterize()
+	{
+		if (_operations.empty())
+			return;
+
+		const std::uint32_t tileSize = _configuration.tileSize;
+		const std::uint32_t columns = (_framebuffer.size.x + tileSize - 1) / tileSize;
+		const std::uint32_t rows = (_framebuffer.size.y + tileSize - 1) / tileSize;
+
+		const std::size_t tileCount = static_cast<std::size_t>(columns) * rows;
+		const auto rasterizeTiles = [&](std::size_t begin, std::size_t end) {
+			for (std::size_t index = begin; index < end; ++index)
+			{
+				const auto column = static_cast<std::int32_t>(index % columns);
+				const auto row = static_cast<std::int32_t>(index / columns);
+				const spk::Rect2D tile{
+					.anchor = {column * static_cast<std::int32_t>(tileSize), row * static_cast<std::int32_t>(tileSize)},
+					.size = {tileSize, tileSize}};
+				_rasterizeTile(tile.intersect(_frameArea()));
+			}
+		};
+
+		if (_configuration.jobSystem != nullptr)
+			_configuration.jobSystem->parallelFor(tileCount, rasterizeTiles, 1);
+		else
+			rasterizeTiles(0, tileCount);
+	}
+
+	void SoftwareRenderBackend::_present()
+	{
+		std::unique_ptr<SoftwareFramebuffer> frame = _acquireFrame();
+		if (frame->size != _framebuffer.size)
+			frame->resize(_framebuffer.size);
+		SoftwareRaster::blit(frame->pixels.data(), _framebuffer.pixels.data(), _framebuffer.pixels.size());
+
+		// Captures may outlive the backend, so a released frame only goes back to the recycler if it still exists.
+		_presentedFrame.publish(std::shared_ptr<SoftwareFramebuffer>(
+			frame.release(),
+			[recycler = std::weak_ptr<FrameRecycler>(_frameRecycler)](SoftwareFramebuffer *released) {
+				std::unique_ptr<SoftwareFramebuffer> owned(released);
+				if (const std::shared_ptr<FrameRecycler> alive = recycler.lock())
+				{
+					const std::scoped_lock lock(alive->mutex);
+					if (alive->frames.size() < RecycledFrameCount)
+						alive->frames.push_back(std::move(owned));
+				}
+			}));
+	}
+
+	void SoftwareRenderBackend::execute(const RenderPass &pass, RenderContext &renderContext)
+	{
+		pass.play(*this, renderContext);
+	}
+
+	void SoftwareRenderBackend::beginFrame(const spk::Vector2UInt &size)
+	{
+		if (_framebuffer.size != size)
+			_framebuffer.resize(size);
+		_viewport = _frameArea();
+		_scissor.reset();
+		_operations.clear();
+	}
+
+	void SoftwareRenderBackend::setViewport(const spk::Rect2D &viewport)
+	{
+		_viewport = viewport;
+	}
+
+	void SoftwareRenderBackend::setScissor(const spk::Rect2D &scissor)
+	{
+		_scissor = scissor;
+	}
+
+	void SoftwareRenderBackend::clear(const spk::Color &color, ClearRenderCommand::Mask mask)
+	{
+		if ((mask & ClearRenderCommand::Mask::Color) == ClearRenderCommand::Mask::None)
+			return;
+
+		const spk::Rect2D frameArea = _frameArea();
+		const spk::Rect2D area = _scissor.has_value() ? _scissor->intersect(frameArea) : frameArea;
+		if (area.width == 0 || area.height == 0)
+			return;
+
+		if (area == frameArea)
+			_operations.clear();
+		_operations.push_back(FillOperation{.area = area, .value = SoftwareFramebuffer::pack(color)});
+	}
+
+	void SoftwareRenderBackend::endFrame()
+	{
+		_rasterize();
+		_operations.clear();
+		_present();
+	}
+
+	const SoftwareRenderBackend::Configuration &SoftwareRenderBackend::configuration() const noexcept
+	{
+		return _configuration;
+	}
+
+	const spk::Rect2D &SoftwareRenderBackend::viewport() const noexcept
+	{
+		return _viewport;
+	}
+
+	const SoftwareFramebuffer &SoftwareRenderBackend::framebuffer() const noexcept
+	{
+		return _framebuffer;
+	}
+
+	std::shared_ptr<const SoftwareFramebuffer> SoftwareRenderBackend::presentedFrame() const noexcept
+	{
+		return _presentedFrame.acquireLatest();
+	}
+}
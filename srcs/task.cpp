@@ -0,0 +1,107 @@
+#include "task.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace spk
+{
+	TaskScheduler::TaskScheduler(spk::WakeSignal &wakeSignal, Clock::duration pollingPeriod) :
+		_wakeSignal(wakeSignal),
+		_pollingPeriod(pollingPeriod)
+	{
+	}
+
+	void TaskScheduler::start(Task &task)
+	{
+		if (!task.isValid())
+			throw std::logic_error("Cannot start an empty Task");
+
+		const std::shared_ptr<Task::State> &state = task._handle.promise().state;
+		if (state->scheduler != nullptr)
+			throw std::logic_error("A Task can only be started once");
+		state->scheduler = this;
+		schedule(state);
+	}
+
+	void TaskScheduler::schedule(std::shared_ptr<Task::State> state)
+	{
+		{
+			const std::scoped_lock lock(_mutex);
+			_ready.push_back(std::move(state));
+		}
+		_wakeSignal.notify();
+	}
+
+	void TaskScheduler::defer(std::shared_ptr<Task::State> state)
+	{
+		const std::scoped_lock lock(_mutex);
+		_ready.push_back(std::move(state));
+	}
+
+	void TaskScheduler::scheduleAt(Clock::time_point deadline, std::shared_ptr<Task::State> state)
+	{
+		const std::scoped_lock lock(_mutex);
+		_timers.push_back(TimedEntry{.deadline = deadline, .state = std::move(state)});
+		std::push_heap(_timers.begin(), _timers.end());
+	}
+
+	void TaskScheduler::scheduleWhen(Predicate predicate, std::shared_ptr<Task::State> state)
+	{
+		const std::scoped_lock lock(_mutex);
+		_polled.push_back(PolledEntry{.predicate = std::move(predicate), .state = std::move(state)});
+	}
+
+	void TaskScheduler::resumeReady(Clock::time_point now)
+	{
+		{
+			const std::scoped_lock lock(_mutex);
+			_resuming.swap(_ready);
+			while (!_timers.empty() && _timers.front().deadline <= now)
+			{
+				std::pop_heap(_timers.begin(), _timers.end());
+				_resuming.push_back(std::move(_timers.back().state));
+				_timers.pop_back();
+			}
+			_polling.swap(_polled);
+		}
+
+		// Predicates may reference the frame of their coroutine, so those of destroyed Tasks are never evaluated.
+		std::erase_if(
+			_polling,
+			[this](PolledEntry &entry) {
+				if (entry.state->handle == nullptr)
+					return true;
+				if (!entry.predicate())
+					return false;
+				_resuming.push_back(std::move(entry.state));
+				return true;
+			});
+		if (!_polling.empty())
+		{
+			const std::scoped_lock lock(_mutex);
+			_polled.insert(_polled.end(), std::make_move_iterator(_polling.begin()), std::make_move_iterator(_polling.end()));
+		}
+		_polling.clear();
+
+		for (const std::shared_ptr<Task::State> &state : _resuming)
+		{
+			if (state->handle != nullptr && !state->handle.done())
+				state->handle.resume();
+		}
+		_resuming.clear();
+	}
+
+	std::optional<TaskScheduler::Clock::time_point> TaskScheduler::nextDeadline(Clock::time_point now) const
+	{
+		const std::scoped_lock lock(_mutex);
+		std::optional<Clock::time_point> result;
+		if (!_timers.empty())
+			result = _timers.front().deadline;
+		// Deferred and polling coroutines only need one cycle per polling period, not a spinning update thread.
+		const bool needsCycle = !_ready.empty() || !_polled.empty();
+		if (needsCycle && (!result.has_value() || now + _pollingPeriod < *result))
+			result = now + _pollingPeriod;
+		return result;
+	}
+}
@@ -1,8 +1,6 @@
 #include "viewport_render_command.hpp"
 
-#include <Windows.h>
-#include <gl/gl.h>
-
+#include "render_backend.hpp"
 #include "render_context.hpp"
 
 namespace spk
@@ -14,12 +12,6 @@ namespace spk
 
 	void ViewportRenderCommand::execute(RenderContext &renderContext) const
 	{
-		const GLint y = static_cast<GLint>(renderContext.targetSurface->geometry().size.y) - _viewport.y - static_cast<GLint>(_viewport.height);
-
-		::glViewport(
-			static_cast<GLint>(_viewport.x),
-			y,
-			static_cast<GLsizei>(_viewport.width),
-			static_cast<GLsizei>(_viewport.height));
+		renderContext.backend->setViewport(_viewport);
 	}
-}
\ No newline at end of file
+}
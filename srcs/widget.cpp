@@ -1,9 +1,13 @@
 #include "widget.hpp"
 
 #include <cmath>
+#include <type_traits>
 #include <utility>
 
+#include "job_system.hpp"
+#include "profiler.hpp"
 #include "update_context.hpp"
+#include "widget_spatial_index.hpp"
 
 #include "scissor_render_command.hpp"
 #include "viewport_render_command.hpp"
@@ -37,20 +41,53 @@ namespace spk
 			return result;
 		})
 	{
+#if defined(SPARKLE_ENABLE_PROFILER)
+		_profileName = Profiler::intern(this->name());
+#endif
 		setParent(parent);
+		_renderedParent = this->parent();
+		_markSubtreeRenderDirty();
 		_computeRatio();
 		_onParentEditedContract = subscribeToParentEdition([this](const Widget *) {
 			_computeRatio();
+			_adoptSpatialIndex(hasParent() ? this->parent()->_spatialIndex : nullptr);
 			_invalidateAbsoluteZOrder();
 			_invalidateViewRegion();
+			if (_renderedParent != nullptr)
+			{
+				_renderedParent->_markSubtreeRenderDirty();
+			}
+			_renderedParent = this->parent();
+			_markSubtreeRenderDirty();
+		});
+		_onActivationContract = subscribeToActivation([this] {
+			_markSubtreeRenderDirty();
+			_markSpatialSubtreeDirty();
 		});
+		_onDeactivationContract = subscribeToDeactivation([this] {
+			_markSubtreeRenderDirty();
+			_markSpatialSubtreeDirty();
+		});
+		_adoptSpatialIndex(hasParent() ? this->parent()->_spatialIndex : nullptr);
 	}
 
-	Widget::~Widget() = default;
+	Widget::~Widget()
+	{
+		if (_spatialIndex != nullptr)
+		{
+			_spatialIndex->remove(*this);
+		}
+	}
 
 	void Widget::_invalidateViewRegion()
 	{
 		_viewRegion.invalidate();
+		_isRenderDirty = true;
+		_setSubtreeRenderDirty();
+		if (_spatialIndex != nullptr)
+		{
+			_spatialIndex->markDirty(*this);
+		}
 		for (Widget *child : children())
 		{
 			if (child != nullptr)
@@ -72,6 +109,26 @@ namespace spk
 		}
 	}
 
+	void Widget::_setSubtreeRenderDirty() noexcept
+	{
+		if (!_isSubtreeRenderDirty)
+		{
+			_isSubtreeRenderDirty = true;
+			++_renderRevision;
+		}
+	}
+
+	void Widget::_markSubtreeRenderDirty()
+	{
+		// A dirty ancestor already has its whole chain marked, unless it is inactive, in which case it is skipped
+		// by the snapshot anyway and marks its own ancestors when it gets activated.
+		_setSubtreeRenderDirty();
+		for (Widget *ancestor = parent(); ancestor != nullptr && !ancestor->_isSubtreeRenderDirty; ancestor = ancestor->parent())
+		{
+			ancestor->_setSubtreeRenderDirty();
+		}
+	}
+
 	void Widget::_computeRatio()
 	{
 		const spk::Vector2UInt referenceSize = hasParent() ? parent()->_geometry.size : _geometry.size;
@@ -94,6 +151,7 @@ namespace spk
 	{
 		_geometry = geometry;
 		_viewRegion.invalidate();
+		markRenderDirty();
 		for (Widget *child : children())
 		{
 			if (child != nullptr)
@@ -125,6 +183,118 @@ namespace spk
 		(this->*handler)(event);
 	}
 
+	void Widget::_adoptSpatialIndex(WidgetSpatialIndex *spatialIndex)
+	{
+		if (_spatialIndex == spatialIndex)
+		{
+			return;
+		}
+		if (_spatialIndex != nullptr)
+		{
+			_spatialIndex->remove(*this);
+		}
+		_spatialIndex = spatialIndex;
+		if (_spatialIndex != nullptr)
+		{
+			_spatialIndex->insert(*this);
+		}
+		for (Widget *child : children())
+		{
+			if (child != nullptr)
+			{
+				child->_adoptSpatialIndex(spatialIndex);
+			}
+		}
+	}
+
+	void Widget::_markSpatialSubtreeDirty()
+	{
+		if (_spatialIndex == nullptr)
+		{
+			return;
+		}
+		_spatialIndex->markDirty(*this);
+		for (Widget *child : children())
+		{
+			if (child != nullptr)
+			{
+				child->_markSpatialSubtreeDirty();
+			}
+		}
+	}
+
+	bool Widget::_routesSpatially() const noexcept
+	{
+		return _spatialIndex != nullptr && &_spatialIndex->root() == this;
+	}
+
+	void Widget::_notifyHoverChange(const BaseEventRecord &source, const std::vector<Widget *> &left, const std::vector<Widget *> &entered)
+	{
+		// Every widget gets its own event, so one consuming its hover change does not hide it from the others.
+		MouseLeftRecord leftRecord;
+		leftRecord.windowHandle = source.windowHandle;
+		leftRecord.timestamp = source.timestamp;
+		for (Widget *widget : left)
+		{
+			MouseLeftEvent event(leftRecord);
+			widget->_onMouseLeftEvent(event);
+		}
+
+		MouseEnteredRecord enteredRecord;
+		enteredRecord.windowHandle = source.windowHandle;
+		enteredRecord.timestamp = source.timestamp;
+		for (Widget *widget : entered)
+		{
+			MouseEnteredEvent event(enteredRecord);
+			widget->_onMouseEnteredEvent(event);
+		}
+	}
+
+	template <typename TEvent>
+	void Widget::_route(TEvent &event, void (Widget::*handler)(TEvent &))
+	{
+		if (!_routesSpatially())
+		{
+			_propagate(event, handler);
+			return;
+		}
+		if (event.consumed)
+		{
+			return;
+		}
+
+		const std::vector<Widget *> hits = _spatialIndex->query(event.device.position);
+		if constexpr (std::is_same_v<TEvent, MouseMovedEvent>)
+		{
+			const WidgetSpatialIndex::HoverChange change = _spatialIndex->updateHover(hits);
+			_notifyHoverChange(event.record, change.left, change.entered);
+		}
+		for (Widget *widget : hits)
+		{
+			(widget->*handler)(event);
+			if (event.consumed)
+			{
+				return;
+			}
+		}
+	}
+
+	void Widget::markRenderDirty()
+	{
+		_isRenderDirty = true;
+		_markSubtreeRenderDirty();
+	}
+
+	bool Widget::isRenderDirty() const noexcept
+	{
+		return _isSubtreeRenderDirty;
+	}
+
+	std::uint64_t Widget::renderRevision() const noexcept
+	{
+		return _renderRevision;
+	}
+
 	void Widget::setZOrder(ZOrder zOrder)
 	{
 		if (_zOrder == zOrder)
@@ -134,6 +304,7 @@ namespace spk
 		_zOrder = zOrder;
 		_invalidateAbsoluteZOrder();
 		notifyOrderingChange();
+		markRenderDirty();
 	}
 
 	Widget::ZOrder Widget::zOrder() const
@@ -154,6 +325,7 @@ namespace spk
 		_geometry = geometry;
 		_computeRatio();
 		_invalidateViewRegion();
+		_markSubtreeRenderDirty();
 		_onGeometryChange();
 	}
 
@@ -173,6 +345,14 @@ namespace spk
 	{
 		return _viewRegion.get();
 	}
+	WidgetSpatialIndex *Widget::spatialIndex() const noexcept
+	{
+		return _spatialIndex;
+	}
+	const char *Widget::profileName() const noexcept
+	{
+		return _profileName;
+	}
 
 	void Widget::dispatch(WindowResizedEvent &event)
 	{
@@ -192,31 +372,41 @@ namespace spk
 	}
 	void Widget::dispatch(MouseEnteredEvent &event)
 	{
+		if (_routesSpatially())
+		{
+			// Hovered widgets are entered by the cursor move that follows.
+			return;
+		}
 		_propagate(event, &Widget::_onMouseEnteredEvent);
 	}
 	void Widget::dispatch(MouseLeftEvent &event)
 	{
+		if (_routesSpatially())
+		{
+			_notifyHoverChange(event.record, _spatialIndex->releaseHover(), {});
+			return;
+		}
 		_propagate(event, &Widget::_onMouseLeftEvent);
 	}
 	void Widget::dispatch(MouseMovedEvent &event)
 	{
-		_propagate(event, &Widget::_onMouseMovedEvent);
+		_route(event, &Widget::_onMouseMovedEvent);
 	}
 	void Widget::dispatch(MouseWheelScrolledEvent &event)
 	{
-		_propagate(event, &Widget::_onMouseWheelScrolledEvent);
+		_route(event, &Widget::_onMouseWheelScrolledEvent);
 	}
 	void Widget::dispatch(MouseButtonPressedEvent &event)
 	{
-		_propagate(event, &Widget::_onMouseButtonPressedEvent);
+		_route(event, &Widget::_onMouseButtonPressedEvent);
 	}
 	void Widget::dispatch(MouseButtonReleasedEvent &event)
 	{
-		_propagate(event, &Widget::_onMouseButtonReleasedEvent);
+		_route(event, &Widget::_onMouseButtonReleasedEvent);
 	}
 	void Widget::dispatch(MouseButtonDoubleClickedEvent &event)
 	{
-		_propagate(event, &Widget::_onMouseButtonDoubleClickedEvent);
+		_route(event, &Widget::_onMouseButtonDoubleClickedEvent);
 	}
 	void Widget::dispatch(KeyPressedEvent &event)
 	{
@@ -238,6 +428,7 @@ namespace spk
 			return;
 		}
 
+		SPARKLE_PROFILE_WIDGET_SCOPE(*this);
 		_updateState(context);
 
 		for (Widget *child : children())
@@ -257,23 +448,137 @@ namespace spk
 		pass.emplace<spk::ScissorRenderCommand>(_viewRegion->scissor);
 	}
 
-	void Widget::buildRenderSnapshot(spk::RenderSnapshot::Builder &builder)
+	void Widget::_rebuildRenderFragments(const spk::RenderSnapshot::Builder &builder)
 	{
-		if (!isActive())
+		SPARKLE_PROFILE_WIDGET_SCOPE(*this);
+		if (_isRenderDirty)
 		{
-			return;
+			auto recorder = builder.recorder();
+			_buildViewRegionCommands(recorder);
+			_buildRenderSnapshot(recorder);
+			_renderFragment = recorder.buildFragment();
+			_isRenderDirty = false;
+		}
+
+		if (children().empty())
+		{
+			_subtreeRenderFragment = _renderFragment;
+		}
+		else
+		{
+			auto recorder = builder.recorder();
+			recorder.splice(_renderFragment);
+			for (Widget *child : children())
+			{
+				if (child != nullptr)
+				{
+					child->buildRenderSnapshot(recorder);
+				}
+			}
+			_subtreeRenderFragment = recorder.buildFragment();
+		}
+
+		_isSubtreeRenderDirty = false;
+	}
+
+	bool Widget::_needsRenderRebuild() const
+	{
+		return isActive() && _isSubtreeRenderDirty;
+	}
+
+	std::size_t Widget::_planRenderJobs(RenderJobPlan &plan, std::size_t granularity)
+	{
+		// Jobs only touch their own subtree, so the caches they inherit from their ancestors are resolved here.
+		static_cast<void>(viewRegion());
+		static_cast<void>(absoluteZOrder());
+
+		std::size_t work = 1;
+		bool isSplit = false;
+		for (Widget *child : children())
+		{
+			if (child != nullptr && child->_needsRenderRebuild())
+			{
+				child->_plannedRenderWork = child->_planRenderJobs(plan, granularity);
+				if (child->_plannedRenderWork == SplitRenderWork)
+				{
+					isSplit = true;
+				}
+				else
+				{
+					work += child->_plannedRenderWork;
+				}
+			}
 		}
 
-		_buildViewRegionCommands(builder);
-		_buildRenderSnapshot(builder);
+		if (!isSplit && work <= granularity)
+		{
+			return work;
+		}
 
+		std::size_t batchWork = 0;
 		for (Widget *child : children())
 		{
-			if (child != nullptr)
+			if (child == nullptr || !child->_needsRenderRebuild() || child->_plannedRenderWork == SplitRenderWork)
+			{
+				continue;
+			}
+			plan.widgets.push_back(child);
+			batchWork += child->_plannedRenderWork;
+			if (batchWork >= granularity)
 			{
-				child->buildRenderSnapshot(builder);
+				plan.batchEnds.push_back(plan.widgets.size());
+				batchWork = 0;
 			}
 		}
+		if (batchWork != 0)
+		{
+			plan.batchEnds.push_back(plan.widgets.size());
+		}
+		return SplitRenderWork;
+	}
+
+	void Widget::_rebuildRenderFragmentsInParallel(const spk::RenderSnapshot::Builder &builder)
+	{
+		RenderJobPlan plan;
+		if (_planRenderJobs(plan, builder.parallelGranularity()) != SplitRenderWork || plan.batchEnds.size() < 2)
+		{
+			return;
+		}
+
+		builder.jobSystem()->parallelFor(
+			plan.batchEnds.size(),
+			[&](std::size_t firstBatch, std::size_t endBatch) {
+				for (std::size_t batch = firstBatch; batch < endBatch; ++batch)
+				{
+					const std::size_t begin = batch != 0 ? plan.batchEnds[batch - 1] : 0;
+					for (std::size_t index = begin; index < plan.batchEnds[batch]; ++index)
+					{
+						plan.widgets[index]->_rebuildRenderFragments(builder);
+					}
+				}
+			},
+			1);
+	}
+
+	void Widget::buildRenderSnapshot(spk::RenderSnapshot::Builder &builder)
+	{
+		if (!isActive())
+		{
+			return;
+		}
+
+		if (_isSubtreeRenderDirty && builder.jobSystem() != nullptr)
+		{
+			// Rebuilds the large dirty subtrees concurrently; the sequential pass below then only splices them in order.
+			_rebuildRenderFragmentsInParallel(builder);
+		}
+
+		if (_isSubtreeRenderDirty)
+		{
+			_rebuildRenderFragments(builder);
+		}
+
+		builder.splice(_subtreeRenderFragment);
 	}
 
 	void Widget::_updateState(UpdateContext &)
@@ -0,0 +1,231 @@
+#include "widget_spatial_index.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "widget.hpp"
+
+namespace spk
+{
+	WidgetSpatialIndex::WidgetSpatialIndex(Widget &root, std::int32_t cellSize) :
+		_root(root),
+		_cellSize(std::max<std::int32_t>(cellSize, 1))
+	{
+		_root._adoptSpatialIndex(this);
+	}
+
+	WidgetSpatialIndex::~WidgetSpatialIndex()
+	{
+		for (auto &[widget, entry] : _entries)
+			widget->_spatialIndex = nullptr;
+	}
+
+	Widget &WidgetSpatialIndex::root() const noexcept
+	{
+		return _root;
+	}
+
+	std::uint64_t WidgetSpatialIndex::_cellKey(std::int32_t x, std::int32_t y) noexcept
+	{
+		return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y);
+	}
+
+	std::int32_t WidgetSpatialIndex::_cellCoordinate(std::int32_t value) const noexcept
+	{
+		// Rounds towards negative infinity, so cells keep the same size on both sides of the origin.
+		return value >= 0 ? value / _cellSize : -((-(value + 1)) / _cellSize) - 1;
+	}
+
+	bool WidgetSpatialIndex::_isReachable(const Widget &widget) const
+	{
+		for (const Widget *current = &widget; current != nullptr; current = current->parent())
+		{
+			if (!current->isActive())
+				return false;
+			if (current == &_root)
+				return true;
+		}
+		return false;
+	}
+
+	void WidgetSpatialIndex::_link(Widget &widget, Entry &entry)
+	{
+		const spk::Rect2D &scissor = widget.viewRegion().scissor;
+		if (scissor.size.x == 0 || scissor.size.y == 0)
+			return;
+
+		entry.firstCell = {_cellCoordinate(scissor.anchor.x), _cellCoordinate(scissor.anchor.y)};
+		entry.lastCell = {
+			_cellCoordinate(scissor.anchor.x + static_cast<std::int32_t>(scissor.size.x) - 1),
+			_cellCoordinate(scissor.anchor.y + static_cast<std::int32_t>(scissor.size.y) - 1)};
+		for (std::int32_t y = entry.firstCell.y; y <= entry.lastCell.y; ++y)
+		{
+			for (std::int32_t x = entry.firstCell.x; x <= entry.lastCell.x; ++x)
+				_cells[_cellKey(x, y)].push_back(&widget);
+		}
+		entry.isIndexed = true;
+	}
+
+	void WidgetSpatialIndex::_unlink(Widget &widget, Entry &entry)
+	{
+		if (!entry.isIndexed)
+			return;
+
+		for (std::int32_t y = entry.firstCell.y; y <= entry.lastCell.y; ++y)
+		{
+			for (std::int32_t x = entry.firstCell.x; x <= entry.lastCell.x; ++x)
+			{
+				const auto cell = _cells.find(_cellKey(x, y));
+				if (cell == _cells.end())
+					continue;
+				std::erase(cell->second, &widget);
+				if (cell->second.empty())
+					_cells.erase(cell);
+			}
+		}
+		entry.isIndexed = false;
+	}
+
+	void WidgetSpatialIndex::_flush()
+	{
+		// Removed widgets stay in the list with no entry, and a widget flagged twice is only processed once.
+		for (Widget *widget : std::exchange(_dirtyWidgets, {}))
+		{
+			const auto iterator = _entries.find(widget);
+			if (iterator == _entries.end() || !iterator->second.isDirty)
+				continue;
+
+			Entry &entry = iterator->second;
+			entry.isDirty = false;
+			_unlink(*widget, entry);
+			if (_isReachable(*widget))
+				_link(*widget, entry);
+		}
+	}
+
+	void WidgetSpatialIndex::_sortInDispatchOrder(std::vector<Widget *> &widgets) const
+	{
+		if (widgets.size() < 2)
+			return;
+
+		struct Path
+		{
+			Widget *widget;
+			std::vector<const Widget *> ancestors;
+		};
+
+		std::vector<Path> paths;
+		paths.reserve(widgets.size());
+		for (Widget *widget : widgets)
+		{
+			Path path{.widget = widget, .ancestors = {}};
+			for (const Widget *current = widget; current != nullptr; current = current->parent())
+				path.ancestors.push_back(current);
+			std::ranges::reverse(path.ancestors);
+			paths.push_back(std::move(path));
+		}
+
+		// Widget::dispatch visits children in their sorted order, each subtree before its parent.
+		std::ranges::sort(paths, [](const Path &lhs, const Path &rhs) {
+			const std::size_t commonLength = std::min(lhs.ancestors.size(), rhs.ancestors.size());
+			std::size_t depth = 0;
+			while (depth < commonLength && lhs.ancestors[depth] == rhs.ancestors[depth])
+				++depth;
+			if (depth == commonLength)
+				return lhs.ancestors.size() > rhs.ancestors.size();
+
+			const Widget *left = lhs.ancestors[depth];
+			const Widget *right = rhs.ancestors[depth];
+			if (left->zOrder() != right->zOrder())
+				return left->zOrder() < right->zOrder();
+			if (depth == 0)
+				return left < right;
+			const auto &siblings = lhs.ancestors[depth - 1]->children();
+			return std::ranges::find(siblings, left) < std::ranges::find(siblings, right);
+		});
+
+		for (std::size_t index = 0; index < paths.size(); ++index)
+			widgets[index] = paths[index].widget;
+	}
+
+	void WidgetSpatialIndex::insert(Widget &widget)
+	{
+		_entries.try_emplace(&widget);
+		markDirty(widget);
+	}
+
+	void WidgetSpatialIndex::remove(Widget &widget)
+	{
+		const auto iterator = _entries.find(&widget);
+		if (iterator == _entries.end())
+			return;
+		_unlink(widget, iterator->second);
+		_entries.erase(iterator);
+		std::erase(_hoveredWidgets, &widget);
+	}
+
+	void WidgetSpatialIndex::markDirty(Widget &widget)
+	{
+		const auto iterator = _entries.find(&widget);
+		if (iterator == _entries.end() || iterator->second.isDirty)
+			return;
+		iterator->second.isDirty = true;
+		_dirtyWidgets.push_back(&widget);
+	}
+
+	std::vector<Widget *> WidgetSpatialIndex::query(const spk::Vector2Int &position)
+	{
+		_flush();
+
+		std::vector<Widget *> result;
+		const auto cell = _cells.find(_cellKey(_cellCoordinate(position.x), _cellCoordinate(position.y)));
+		if (cell == _cells.end())
+			return result;
+
+		for (Widget *widget : cell->second)
+		{
+			if (widget->viewRegion().scissor.contains(position))
+				result.push_back(widget);
+		}
+		_sortInDispatchOrder(result);
+		return result;
+	}
+
+	WidgetSpatialIndex::HoverChange WidgetSpatialIndex::updateHover(const std::vector<Widget *> &hits)
+	{
+		HoverChange result;
+		for (Widget *widget : _hoveredWidgets)
+		{
+			if (std::ranges::find(hits, widget) == hits.end())
+				result.left.push_back(widget);
+		}
+		for (Widget *widget : hits)
+		{
+			if (std::ranges::find(_hoveredWidgets, widget) == _hoveredWidgets.end())
+				result.entered.push_back(widget);
+		}
+		_hoveredWidgets = hits;
+		return result;
+	}
+
+	std::vector<Widget *> WidgetSpatialIndex::releaseHover()
+	{
+		return std::exchange(_hoveredWidgets, {});
+	}
+
+	const std::vector<Widget *> &WidgetSpatialIndex::hoveredWidgets() const noexcept
+	{
+		return _hoveredWidgets;
+	}
+
+	WidgetSpatialIndex::Statistics WidgetSpatialIndex::statistics() const
+	{
+		Statistics result{.widgetCount = _entries.size(), .indexedWidgetCount = 0, .occupiedCellCount = _cells.size()};
+		for (const auto &[widget, entry] : _entries)
+		{
+			if (entry.isIndexed)
+				++result.indexedWidgetCount;
+		}
+		return result;
+	}
+}
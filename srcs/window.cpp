@@ -6,11 +6,17 @@
 
 namespace spk
 {
-	Window::Window(std::shared_ptr<Native> native, std::shared_ptr<State> state, std::shared_ptr<Surface> surface) :
-		_native(std::move(native)), _state(std::move(state)), _surface(std::move(surface))
+	Window::Window(Handle handle, std::shared_ptr<Native> native, std::shared_ptr<State> state, std::shared_ptr<Surface> surface,
+		std::shared_ptr<Latency> latency) :
+		_handle(handle), _native(std::move(native)), _state(std::move(state)), _surface(std::move(surface)), _latency(std::move(latency))
 	{
 	}
 
+	Window::Handle Window::handle() const noexcept
+	{
+		return _handle;
+	}
+
 	bool Window::isClosing() const noexcept
 	{
 		if (isClosed())
@@ -43,4 +49,23 @@ namespace spk
 	{
 		return _surface->geometry();
 	}
+
+	std::shared_ptr<const SoftwareFramebuffer> Window::capture() const
+	{
+		return _surface->capture();
+	}
+
+	Window::UpdateStatistics Window::updateStatistics() const
+	{
+		return _state->updateStatistics();
+	}
+
+	Window::LatencyStatistics Window::latencyStatistics() const
+	{
+		return LatencyStatistics{
+			.inputToDispatch = _latency->inputToDispatch.summary(),
+			.dispatchToSnapshot = _latency->dispatchToSnapshot.summary(),
+			.snapshotToPresent = _latency->snapshotToPresent.summary(),
+			.inputToPresent = _latency->inputToPresent.summary()};
+	}
 }
@@ -3,7 +3,11 @@
 #include <atomic>
 #include <utility>
 
+#if defined(SPARKLE_PLATFORM_WINAPI)
 #include "frame.hpp"
+#elif defined(SPARKLE_PLATFORM_HEADLESS)
+#include "headless_frame.hpp"
+#endif
 
 namespace spk
 {
@@ -11,7 +15,7 @@ namespace spk
 	{
 		Window::Identifier windowID;
 		std::atomic<LifeCycle> lifeCycle = LifeCycle::Pending;
-		WinAPI::Frame frame;
+		Platform::Frame frame;
 
 		explicit Impl(Window::Identifier windowID) : windowID(std::move(windowID)) {}
 	};
@@ -24,12 +28,12 @@ namespace spk
 		return _impl->lifeCycle.load();
 	}
 
-	WinAPI::Frame &Window::Native::frame() noexcept
+	Platform::Frame &Window::Native::frame() noexcept
 	{
 		return _impl->frame;
 	}
 
-	const WinAPI::Frame &Window::Native::frame() const noexcept
+	const Platform::Frame &Window::Native::frame() const noexcept
 	{
 		return _impl->frame;
 	}
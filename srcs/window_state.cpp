@@ -1,14 +1,17 @@
 #include "window.hpp"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include "keyboard.hpp"
 #include "mouse.hpp"
 #include "widget.hpp"
+#include "widget_spatial_index.hpp"
 
 #include "clear_render_command.hpp"
 
@@ -43,6 +46,7 @@ namespace spk
 		void setBackgroundColor(const spk::Color& backgroundColor)
 		{
 			_backgroundColor = backgroundColor;
+			markRenderDirty();
 		}
 	};
 	struct Window::State::Impl
@@ -50,14 +54,18 @@ namespace spk
 		Window::Identifier windowID;
 		std::atomic<LifeCycle> lifeCycle = LifeCycle::Pending;
 		std::unique_ptr<RootWidget> root;
+		std::unique_ptr<WidgetSpatialIndex> spatialIndex;
 		std::array<Widget *, FocusMode::ChannelCount> focusedWidgets{};
 		spk::Keyboard keyboard;
 		spk::Mouse mouse;
+		mutable std::mutex updateStatisticsMutex;
+		UpdateStatistics updateStatistics;
 
 		explicit Impl(Window::Identifier windowID) :
 			windowID(std::move(windowID)), root(std::make_unique<RootWidget>("/Root widget", nullptr))
 		{
 			root->activate();
+			spatialIndex = std::make_unique<WidgetSpatialIndex>(*root);
 		}
 	};
 
@@ -84,6 +92,27 @@ namespace spk
 		_impl->root->setBackgroundColor(backgroundColor);
 	}
 
+	std::uint64_t Window::State::renderRevision() const noexcept
+	{
+		return _impl->root->renderRevision();
+	}
+
+	void Window::State::recordUpdate(UpdateStatistics::Clock::duration duration)
+	{
+		const std::scoped_lock lock(_impl->updateStatisticsMutex);
+		UpdateStatistics &statistics = _impl->updateStatistics;
+		++statistics.updateCount;
+		statistics.lastDuration = duration;
+		statistics.totalDuration += duration;
+		statistics.maximalDuration = std::max(statistics.maximalDuration, duration);
+	}
+
+	Window::UpdateStatistics Window::State::updateStatistics() const
+	{
+		const std::scoped_lock lock(_impl->updateStatisticsMutex);
+		return _impl->updateStatistics;
+	}
+
 	void Window::State::takeFocus(FocusMode::Channel channel, Widget *widget) noexcept
 	{
 		if (widget != nullptr)
@@ -0,0 +1,93 @@
+#include "window.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+
+#include "gpu_resource_collection.hpp"
+#include "headless_frame.hpp"
+#include "profiler.hpp"
+#include "software_render_backend.hpp"
+
+namespace spk
+{
+	struct Window::Surface::Impl
+	{
+		Window::Identifier windowID;
+		std::atomic<LifeCycle> lifeCycle = LifeCycle::Pending;
+		std::unique_ptr<GPUResourceCollection> _gpuResources;
+		spk::Rect2D geometry;
+		SoftwareRenderBackend backend;
+
+		Impl(Window::Identifier windowID, spk::JobSystem *jobSystem) :
+			windowID(std::move(windowID)),
+			_gpuResources(std::make_unique<GPUResourceCollection>()),
+			backend(SoftwareRenderBackend::Configuration{.jobSystem = jobSystem})
+		{
+		}
+	};
+
+	Window::Surface::Surface(const Window::Identifier &windowID, spk::JobSystem *jobSystem) :
+		_impl(std::make_unique<Impl>(windowID, jobSystem))
+	{
+	}
+	Window::Surface::~Surface() = default;
+
+	Window::LifeCycle Window::Surface::lifeCycle() const noexcept
+	{
+		return _impl->lifeCycle.load();
+	}
+
+	void Window::Surface::create(const Headless::Frame &frame)
+	{
+		if (_impl->lifeCycle != LifeCycle::Pending)
+		{
+			throw std::logic_error("The headless surface cannot be created in its current state");
+		}
+		_impl->geometry = frame.geometry();
+		_impl->lifeCycle = LifeCycle::Ready;
+	}
+
+	void Window::Surface::destroy()
+	{
+		_impl->lifeCycle = LifeCycle::Released;
+	}
+
+	void Window::Surface::makeCurrent()
+	{
+		if (_impl->lifeCycle != LifeCycle::Ready)
+		{
+			throw std::logic_error("Cannot activate an uninitialized headless surface");
+		}
+	}
+
+	void Window::Surface::setGeometry(const spk::Rect2D &geometry) noexcept
+	{
+		_impl->geometry = geometry;
+	}
+
+	const spk::Rect2D &Window::Surface::geometry() const noexcept
+	{
+		return _impl->geometry;
+	}
+
+	GPUResourceCollection &Window::Surface::_gpuResources()
+	{
+		return *_impl->_gpuResources;
+	}
+
+	RenderBackend &Window::Surface::backend() noexcept
+	{
+		return _impl->backend;
+	}
+
+	std::shared_ptr<const SoftwareFramebuffer> Window::Surface::capture() const
+	{
+		return _impl->backend.presentedFrame();
+	}
+
+	void Window::Surface::present()
+	{
+		SPARKLE_PROFILE_SCOPE("Window::Surface::present");
+	}
+}
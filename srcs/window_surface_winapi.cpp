@@ -12,6 +12,8 @@
 
 #include "frame.hpp"
 #include "gpu_resource_collection.hpp"
+#include "opengl_render_backend.hpp"
+#include "profiler.hpp"
 
 namespace spk
 {
@@ -34,6 +36,7 @@ namespace spk
 		HDC deviceContext = nullptr;
 		HGLRC renderingContext = nullptr;
 		spk::Rect2D geometry;
+		OpenGLRenderBackend backend;
 
 		explicit Impl(Window::Identifier windowID) :
 			windowID(std::move(windowID)),
@@ -199,7 +202,7 @@ namespace spk
 		}
 	};
 
-	Window::Surface::Surface(const Window::Identifier &windowID) :
+	Window::Surface::Surface(const Window::Identifier &windowID, spk::JobSystem *) :
 		_impl(std::make_unique<Impl>(windowID))
 	{
 	}
@@ -300,8 +303,19 @@ namespace spk
 		return *_impl->_gpuResources;
 	}
 
+	RenderBackend &Window::Surface::backend() noexcept
+	{
+		return _impl->backend;
+	}
+
+	std::shared_ptr<const SoftwareFramebuffer> Window::Surface::capture() const
+	{
+		return nullptr;
+	}
+
 	void Window::Surface::present()
 	{
+		SPARKLE_PROFILE_SCOPE("Window::Surface::present");
 		if (_impl->deviceContext == nullptr)
 		{
 			throw std::logic_error("Cannot present an uninitialized OpenGL surface");